@@ -0,0 +1,205 @@
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+#include <QVarLengthArray>
+
+/**
+ * @brief Позиции элемента в списках смежности, в которые он входит
+ *
+ * Хранится в самом элементе (например, в связи - по одной позиции на каждый из двух узлов),
+ * поэтому проверка принадлежности и удаление из списка не требуют поиска по списку.
+ * @tparam N Наибольшее число списков, в которые одновременно входит элемент
+ */
+template <int N>
+class AdjacencySlots
+{
+public:
+    /**
+     * @brief Возвращает позицию элемента в списке
+     * @param list Список смежности
+     * @return Указатель на позицию или nullptr, если элемент не входит в список
+     */
+    int *find(const void *list)
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.list == list)
+            {
+                return &slot.index;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Занимает свободную позицию для списка
+     * @param list Список смежности
+     * @return Указатель на позицию или nullptr, если свободных позиций нет
+     */
+    int *acquire(const void *list)
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.list == nullptr)
+            {
+                slot.list = list;
+                return &slot.index;
+            }
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Освобождает позицию списка
+     * @param list Список смежности
+     */
+    void release(const void *list)
+    {
+        for (Slot &slot : m_slots)
+        {
+            if (slot.list == list)
+            {
+                slot = Slot();
+                return;
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        const void *list = nullptr;
+        int index = -1;
+    };
+    Slot m_slots[N];
+};
+
+/**
+ * @brief Непрерывный диапазон элементов без копирования
+ * @tparam T Тип элемента
+ */
+template <typename T>
+class AdjacencySpan
+{
+public:
+    AdjacencySpan(T *const *begin, T *const *end) : m_begin(begin), m_end(end) {}
+
+    T *const *begin() const { return m_begin; }
+    T *const *end() const { return m_end; }
+    int size() const { return int(m_end - m_begin); }
+    bool empty() const { return m_begin == m_end; }
+    T *operator[](int i) const { return m_begin[i]; }
+
+private:
+    T *const *m_begin;
+    T *const *m_end;
+};
+
+/**
+ * @brief Список смежности с хранением первых элементов внутри объекта
+ *
+ * Первые Prealloc элементов хранятся без выделения памяти (у большинства узлов платы
+ * одна-три связи). Каждый элемент хранит свою позицию в списке (метод adjacencySlots()),
+ * поэтому проверка принадлежности, добавление и удаление выполняются за O(1).
+ * При удалении на место элемента переносится последний, порядок элементов не сохраняется.
+ *
+ * @tparam T Тип элемента, должен предоставлять константный метод adjacencySlots(),
+ *           возвращающий изменяемую ссылку на AdjacencySlots (поле объявляется mutable)
+ * @tparam Prealloc Число элементов, хранимых внутри объекта
+ */
+template <typename T, int Prealloc = 4>
+class AdjacencyList
+{
+public:
+    AdjacencyList() = default;
+    AdjacencyList(const AdjacencyList &) = delete;
+    AdjacencyList &operator=(const AdjacencyList &) = delete;
+
+    /**
+     * @brief Деструктор, освобождает позиции элементов
+     */
+    ~AdjacencyList() { clear(); }
+
+    /**
+     * @brief Проверяет, входит ли элемент в список
+     * @param item Элемент
+     * @return true если элемент в списке
+     */
+    bool contains(const T *item) const
+    {
+        return item->adjacencySlots().find(this) != nullptr;
+    }
+
+    /**
+     * @brief Добавляет элемент, если его еще нет в списке
+     * @param item Элемент
+     * @return true если элемент добавлен
+     */
+    bool add(T *item)
+    {
+        if (contains(item))
+        {
+            return false;
+        }
+        int *slot = item->adjacencySlots().acquire(this);
+        if (!slot)
+        {
+            return false;
+        }
+        *slot = m_items.size();
+        m_items.append(item);
+        return true;
+    }
+
+    /**
+     * @brief Удаляет элемент из списка
+     * @param item Элемент
+     * @return true если элемент был в списке
+     */
+    bool remove(T *item)
+    {
+        int *slot = item->adjacencySlots().find(this);
+        if (!slot)
+        {
+            return false;
+        }
+        int index = *slot;
+        T *last = m_items.last();
+        m_items[index] = last;
+        *last->adjacencySlots().find(this) = index;
+        m_items.removeLast();
+        item->adjacencySlots().release(this);
+        return true;
+    }
+
+    /**
+     * @brief Удаляет все элементы
+     */
+    void clear()
+    {
+        for (T *item : m_items)
+        {
+            item->adjacencySlots().release(this);
+        }
+        m_items.clear();
+    }
+
+    /**
+     * @brief Возвращает элементы списка без копирования
+     * @return Диапазон элементов, действителен до изменения списка
+     */
+    AdjacencySpan<T> items() const
+    {
+        return AdjacencySpan<T>(m_items.constData(), m_items.constData() + m_items.size());
+    }
+
+    int size() const { return int(m_items.size()); }
+    bool empty() const { return m_items.isEmpty(); }
+    T *const *begin() const { return m_items.constData(); }
+    T *const *end() const { return m_items.constData() + m_items.size(); }
+
+private:
+    QVarLengthArray<T *, Prealloc> m_items;
+};
+
+#endif // ADJACENCY_H
@@ -1,6 +1,8 @@
 #include <QGraphicsScene>
 #include <QPainter>
 #include "Component.h"
+#include "ItemRegistry.h"
+#include "Editor.h"
 
 int Component::s_componentCount = 0;
 
@@ -17,12 +19,37 @@ Pad::Pad(const QString &name, int id, const QPointF &position, int number) : Nod
 {
     m_componentId = -1;
     setPos(position);
-    setFlags(QGraphicsItem::ItemIsSelectable);
+    setFlags(QGraphicsItem::ItemIsSelectable | QGraphicsItem::ItemSendsGeometryChanges);
     m_showOnHover = false;
     setOpacity(1);
+    ItemRegistry::instance().add<Pad>(m_id, this);
+}
+
+Pad::~Pad()
+{
+    ItemRegistry::instance().remove<Pad>(m_id, this);
 }
 
-Component::Component(const QString &name, int id) : m_name(name), m_id(id) {}
+void Pad::hoverEnterEvent(QGraphicsSceneHoverEvent *event)
+{
+    Editor::instance()->showStatusMessage(m_name);
+}
+
+void Pad::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
+{
+    Editor::instance()->showStatusMessage("");
+    QGraphicsEllipseItem::hoverLeaveEvent(event);
+}
+
+Component::Component(const QString &name, int id) : m_name(name), m_id(id)
+{
+    ItemRegistry::instance().add<Component>(m_id, this);
+}
+
+Component::~Component()
+{
+    ItemRegistry::instance().remove<Component>(m_id, this);
+}
 
 int Component::numberOfPads() const
 {
@@ -43,10 +70,12 @@ void Component::addPad(Pad *pad)
 void Component::addToScene(QGraphicsScene *scene)
 {
     scene->addItem(this);
+    ItemRegistry::instance().add<Component>(m_id, this);
     for (size_t i = 0; i < m_pads.size(); ++i)
     {
         scene->addItem(m_pads[i]);
         m_pads[i]->setSide(LinkSide::NODE);
+        ItemRegistry::instance().add<Pad>(m_pads[i]->m_id, m_pads[i]);
     }
 }
 
@@ -107,11 +136,14 @@ void Component::remove(QGraphicsScene *scene)
     for (auto pad : m_pads)
     {
         scene->removeItem(pad);
+        ItemRegistry::instance().remove<Pad>(pad->m_id, pad);
+        ItemRegistry::instance().remove<Node>(pad->Node::m_id, static_cast<Node *>(pad));
     }
     m_pads.clear();
 
     // Удаляем сам компонент
     scene->removeItem(this);
+    ItemRegistry::instance().remove<Component>(m_id, this);
 }
 
 int Component::genComponentId()
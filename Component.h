@@ -18,6 +18,14 @@ class PhantomPad : public Node
 public:
     QString m_name; ///< Имя виртуального контакта
 
+    enum { Type = PhantomPadItem, LastType = Type }; ///< Тип элемента для item_cast
+
+    /**
+     * @brief Возвращает тип элемента сцены
+     * @return PhantomPad::Type
+     */
+    int type() const override { return Type; }
+
     /**
      * @brief Конструктор виртуального контакта
      * @param name Имя контакта
@@ -43,10 +51,38 @@ public:
      */
     Pad(const QString &name, int id, const QPointF &position, int number);
 
+    enum { Type = PadItem, LastType = Type }; ///< Тип элемента для item_cast
+
+    /**
+     * @brief Возвращает тип элемента сцены
+     * @return Pad::Type
+     */
+    int type() const override { return Type; }
+
+    /**
+     * @brief Деструктор контакта
+     *
+     * Удаляет контакт из реестра элементов
+     */
+    ~Pad();
+
     int m_componentId; ///< Идентификатор компонента, к которому принадлежит контакт
     int m_id;          ///< Уникальный идентификатор контакта
     QString m_name;    ///< Имя контакта
     int m_number;      ///< Номер контакта в компоненте
+
+protected:
+    /**
+     * @brief Обработчик события наведения мыши: показывает имя контакта в статусной строке
+     * @param event Событие наведения
+     */
+    void hoverEnterEvent(QGraphicsSceneHoverEvent *event) override;
+
+    /**
+     * @brief Обработчик события ухода мыши: очищает статусную строку
+     * @param event Событие ухода мыши
+     */
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent *event) override;
 };
 
 /**
@@ -65,6 +101,21 @@ public:
      */
     Component(const QString &name, int id);
 
+    enum { Type = ComponentItem, LastType = Type }; ///< Тип элемента для item_cast
+
+    /**
+     * @brief Возвращает тип элемента сцены
+     * @return Component::Type
+     */
+    int type() const override { return Type; }
+
+    /**
+     * @brief Деструктор компонента
+     *
+     * Удаляет компонент из реестра элементов
+     */
+    ~Component();
+
     /**
      * @brief Получает количество контактов компонента
      * @return Количество контактов
@@ -3,7 +3,9 @@
 #include "Node.h"
 #include "Editor.h"
 #include "Component.h"
+#include "ItemRegistry.h"
 #include <QDebug>
+#include <QSettings>
 
 Config *Config::m_instance = nullptr;
 
@@ -32,34 +34,35 @@ Config::Config()
     // Инициализируем другие настройки по умолчанию
     m_linkWidth = 6; // Ширина линий связей
     m_padSize = 12;  // Размер контактных площадок
+    // Бюджет записей истории отмены - настройка пользователя, а не проекта
+    m_undoRecordMemoryMb = QSettings().value("undo/recordMemoryMb", 64).toInt();
 }
 
 void Config::apply()
 {
     int nodeRadius = m_padSize / 2;
 
-    // Применяем настройки ко всем элементам сцены
-    for (QGraphicsItem *item : Editor::instance()->scene()->items())
+    // Применяем настройки к связям каждой цепи
+    for (const auto &[graphId, net] : TrackGraph::nets())
     {
-        if (auto *link = dynamic_cast<Link *>(item))
+        for (Link *link : net.links)
         {
             // Устанавливаем цвет для связей в зависимости от стороны
             link->setColor(ColorUtils::fromLinkSide(link->m_side));
         }
-        else if (auto *node = dynamic_cast<Node *>(item))
-        {
-            // Устанавливаем цвет для узлов
-            node->setColor(Color::NODE);
-        }
-        else if (auto *pad = dynamic_cast<Pad *>(item))
-        {
-            // Устанавливаем цвет для контактов
-            pad->setColor(Color::NODE);
-        }
+    }
+
+    // Устанавливаем цвет для узлов и контактов
+    for (const auto &[id, node] : ItemRegistry::instance().all<Node>())
+    {
+        node->setColor(Color::NODE);
     }
 
     // Перерисовываем цветовую панель
     Editor::instance()->setCurrentSide(Editor::instance()->m_currentSide);
+
+    // Ограничиваем память записей истории отмены
+    Editor::instance()->m_undoHistory.setMemoryBudget(size_t(m_undoRecordMemoryMb) * 1024 * 1024);
 }
 
 void Config::updateFromConfigDialog(const QVariantMap &dialogConfig)
@@ -75,6 +78,11 @@ void Config::updateFromConfigDialog(const QVariantMap &dialogConfig)
     // Обновляем другие настройки
     m_linkWidth = dialogConfig["link_width"].toInt();
     m_padSize = dialogConfig["pad_size"].toInt();
+    if (dialogConfig.contains("undo_record_memory_mb"))
+    {
+        m_undoRecordMemoryMb = dialogConfig["undo_record_memory_mb"].toInt();
+        QSettings().setValue("undo/recordMemoryMb", m_undoRecordMemoryMb);
+    }
 }
 
 void Config::readConfigFromBinary(QDataStream &in)
@@ -95,6 +103,11 @@ QString Config::color(Color color) const
     return m_colors.value(color, "#000000");
 }
 
+void Config::setColor(Color color, const QString &value)
+{
+    m_colors[color] = value;
+}
+
 QVariantMap Config::toDict() const
 {
     // Преобразуем конфигурацию в словарь
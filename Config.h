@@ -38,6 +38,13 @@ public:
      */
     QString color(Color color) const;
 
+    /**
+     * @brief Устанавливает цвет для указанного типа элемента
+     * @param color Тип цвета
+     * @param value Цвет в формате строки
+     */
+    void setColor(Color color, const QString &value);
+
     /**
      * @brief Применяет конфигурацию ко всем элементам сцены
      */
@@ -69,6 +76,7 @@ public:
 
     int m_linkWidth; ///< Ширина линий связей
     int m_padSize;   ///< Размер контактных площадок
+    int m_undoRecordMemoryMb; ///< Бюджет памяти записей истории отмены, МБ (хранится в QSettings, не в проекте)
 
 private:
     /**
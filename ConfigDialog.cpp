@@ -37,6 +37,20 @@ ConfigDialog::ConfigDialog(QWidget *parent)
     padRadiusLayout->addWidget(m_padRadiusSpinBox);
     mainLayout->addLayout(padRadiusLayout);
 
+    // Undo history records memory input
+    QHBoxLayout *undoMemoryLayout = new QHBoxLayout();
+    QLabel *undoMemoryLabel = new QLabel("Undo Net Records (MB):");
+    m_undoRecordMemorySpinBox = new QSpinBox();
+    m_undoRecordMemorySpinBox->setRange(1, 4096);
+    m_undoRecordMemorySpinBox->setValue(Config::instance()->m_undoRecordMemoryMb);
+    m_undoRecordMemorySpinBox->setToolTip("Memory kept for the net id changes of old undo steps; "
+                                          "older records move to a temporary file. "
+                                          "Tracks removed by undoable deletes are not counted.");
+    undoMemoryLabel->setToolTip(m_undoRecordMemorySpinBox->toolTip());
+    undoMemoryLayout->addWidget(undoMemoryLabel);
+    undoMemoryLayout->addWidget(m_undoRecordMemorySpinBox);
+    mainLayout->addLayout(undoMemoryLayout);
+
     // Color pickers
     QList<Color> colors = {Color::FRONT, Color::BACK, Color::WIP, Color::HIGHLIGHTED, Color::NODE};
     for (const auto &color : colors) {
@@ -85,6 +99,7 @@ QVariantMap ConfigDialog::getConfigData() const
     QVariantMap data;
     data["link_width"] = m_trackWidthSpinBox->value();
     data["pad_size"] = m_padRadiusSpinBox->value();
+    data["undo_record_memory_mb"] = m_undoRecordMemorySpinBox->value();
     
     QVariantMap colors;
 
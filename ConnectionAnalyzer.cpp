@@ -1,76 +1,92 @@
-#include <QGraphicsScene>
-#include <QDebug>
 #include <QDialog>
-#include <QTextEdit>
+#include <QTableView>
+#include <QHeaderView>
 #include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QLabel>
 #include <QPushButton>
+#include <QGuiApplication>
+#include <QClipboard>
 #include "ConnectionAnalyzer.h"
+#include "NetlistModel.h"
 #include "Editor.h"
+#include "TrackGraph.h"
+#include "ItemRegistry.h"
+#include "Component.h"
 
-void ConnectionAnalyzer::showResultDialog(const QString& result)
+void ConnectionAnalyzer::showResultDialog(Netlist netlist)
 {
     QDialog dialog(Editor::instance());
     dialog.setWindowTitle("Connection Analysis Results");
-    dialog.setMinimumSize(400, 300);
+    dialog.setMinimumSize(600, 400);
 
     QVBoxLayout* layout = new QVBoxLayout(&dialog);
-    QTextEdit* textEdit = new QTextEdit(&dialog);
-    textEdit->setReadOnly(true);
-    layout->addWidget(textEdit);
 
+    QLabel* summary = new QLabel(QString("%1 nets, %2 pads")
+                                     .arg(netlist.nets().size())
+                                     .arg(netlist.padCount()), &dialog);
+    layout->addWidget(summary);
+
+    NetlistModel* model = new NetlistModel(std::move(netlist), &dialog);
+
+    // The view only asks the model for visible rows; fixed row heights and
+    // column widths keep it from measuring every net up front.
+    QTableView* tableView = new QTableView(&dialog);
+    tableView->setModel(model);
+    tableView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    tableView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    tableView->setWordWrap(false);
+    tableView->verticalHeader()->setVisible(false);
+    tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    tableView->verticalHeader()->setDefaultSectionSize(tableView->fontMetrics().height() + 6);
+    tableView->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    tableView->horizontalHeader()->setStretchLastSection(true);
+    tableView->setColumnWidth(NetlistModel::NetColumn, 70);
+    tableView->setColumnWidth(NetlistModel::PadCountColumn, 60);
+    layout->addWidget(tableView);
+
+    QHBoxLayout* buttons = new QHBoxLayout();
+    QPushButton* copyButton = new QPushButton("Copy", &dialog);
     QPushButton* closeButton = new QPushButton("Close", &dialog);
-    layout->addWidget(closeButton);
+    buttons->addStretch();
+    buttons->addWidget(copyButton);
+    buttons->addWidget(closeButton);
+    layout->addLayout(buttons);
+
+    QObject::connect(copyButton, &QPushButton::clicked, &dialog, [model]() {
+        QGuiApplication::clipboard()->setText(model->netlist().toText());
+    });
     QObject::connect(closeButton, &QPushButton::clicked, &dialog, &QDialog::accept);
 
-    textEdit->setText(result);
-
     dialog.exec();
 }
 
 
-void ConnectionAnalyzer::getConnections()
+Netlist ConnectionAnalyzer::netlist()
 {
-    // Map to store each graph_id and its associated Pad nodes
-    QMap<int, QList<Pad*>> graphIdToPads;
-
-    auto scene = Editor::instance()->getScene();
-
-    for (QGraphicsItem* item : scene->items()) {
-        Link* link = dynamic_cast<Link*>(item);
-        if (link) {
-            int graphId = link->m_graphId;
-
-            // Get nodes from each link's fromNode() and toNode()
-            Node* fromNode = link->fromNode();
-            Node* toNode = link->toNode();
-
-            // Check if the nodes are of class Pad, and add them to the list for the graph_id
-            Pad* fromPad = dynamic_cast<Pad*>(fromNode);
-            if (fromPad && !graphIdToPads[graphId].contains(fromPad)) {
-                graphIdToPads[graphId].append(fromPad);
-            }       
-
-            Pad* toPad = dynamic_cast<Pad*>(toNode);
-            if (toPad && !graphIdToPads[graphId].contains(toPad)) {
-                graphIdToPads[graphId].append(toPad);
-            }
+    ItemRegistry& registry = ItemRegistry::instance();
+
+    std::vector<NetlistNet> nets;
+    nets.reserve(TrackGraph::nets().size());
+    for (const auto& [graphId, net] : TrackGraph::nets()) {
+        // TrackGraph already keeps the pads of each net without repeats
+        if (net.pads.empty()) {
+            continue;
         }
-    }
-
-    QString resultText;
-    for (auto it = graphIdToPads.constBegin(); it != graphIdToPads.constEnd(); ++it) {
-        int graphId = it.key();
-        const QList<Pad*>& pads = it.value();
-
-        QStringList padNames;
-        for (const Pad* pad : pads) {
-            padNames << pad->m_name;
+        NetlistNet entry{graphId, {}};
+        entry.pads.reserve(net.pads.size());
+        for (const auto& [node, linkCount] : net.pads) {
+            const Pad* pad = item_cast<Pad>(node);
+            const Component* component = registry.find<Component>(pad->m_componentId);
+            entry.pads.push_back({pad->m_id, pad->m_componentId, component ? component->m_name : QString(),
+                                  pad->m_name, pad->m_number});
         }
-
-        QString result = padNames.join(" | ");
-        resultText += result + "\n";
+        nets.push_back(std::move(entry));
     }
+    return Netlist(std::move(nets));
+}
 
-    showResultDialog(resultText);
-
-}
\ No newline at end of file
+void ConnectionAnalyzer::getConnections()
+{
+    showResultDialog(netlist());
+}
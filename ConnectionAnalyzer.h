@@ -1,22 +1,19 @@
 #ifndef CONNECTIONANALYZER_H
 #define CONNECTIONANALYZER_H
 
-#include <QMap>
-#include <QList>
-#include <QString>
-#include "Link.h"
-#include "Component.h"
-
-class QGraphicsScene;
+#include "Netlist.h"
 
 class ConnectionAnalyzer
 {
 public:
     static void getConnections();
 
+    // Netlist of the current scene, built from the per-net pads kept by TrackGraph
+    static Netlist netlist();
+
 private:
     ConnectionAnalyzer() = delete;  // Prevent instantiation
-    static void showResultDialog(const QString& result);
+    static void showResultDialog(Netlist netlist);
 };
 
-#endif // CONNECTIONANALYZER_H
\ No newline at end of file
+#endif // CONNECTIONANALYZER_H
@@ -7,6 +7,11 @@
 #include <QGraphicsLineItem>
 #include "QGraphicsItemLayer.h"
 #include "NotesTool.h"
+#include "Link.h"
+#include "NodeIndex.h"
+#include "Config.h"
+#include <QStyleOptionGraphicsItem>
+#include <QFontMetricsF>
 
 /*
  * Функция Editor::m_instance - статическая переменная для хранения единственного экземпляра редактора
@@ -40,7 +45,9 @@ Editor *Editor::instance(QWidget *parent)
  * Выходные данные:
  *   отсутствуют
  */
-Editor::Editor(QWidget *parent) : ZoomableGraphicsView(parent)
+Editor::Editor(QWidget *parent)
+	: ZoomableGraphicsView(parent),
+	  m_undoHistory(&m_undoStack, size_t(Config::instance()->m_undoRecordMemoryMb) * 1024 * 1024)
 {
     m_scene = new QGraphicsScene(this);
     setScene(m_scene);
@@ -76,6 +83,8 @@ Editor::Editor(QWidget *parent) : ZoomableGraphicsView(parent)
     m_layers[LinkSide::WIP]->setZValue(2);
     m_layers[LinkSide::NODE]->setZValue(3);
     m_layers[LinkSide::NOTES]->setZValue(5);
+
+    m_hoverOverlay = addHoverOverlay();
 }
 
 /*
@@ -250,6 +259,58 @@ QGraphicsLineItem *Editor::addTracingIndicator()
     return line;
 }
 
+/*
+ * Функция Editor::addHoverOverlay - добавление подсветки узла под курсором
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   указатель на элемент подсветки
+ */
+QGraphicsEllipseItem *Editor::addHoverOverlay()
+{
+    // над узлами, но под заметками; не перехватывает наведение и нажатия узла под собой
+    QGraphicsEllipseItem *overlay = new QGraphicsEllipseItem();
+    overlay->setZValue(4);
+    overlay->setAcceptHoverEvents(false);
+    overlay->setAcceptedMouseButtons(Qt::NoButton);
+    overlay->setVisible(false);
+    m_scene->addItem(overlay);
+    return overlay;
+}
+
+/*
+ * Функция Editor::showNodeHover - показ подсветки узла под курсором
+ * Входные параметры:
+ *   node - узел под курсором
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Editor::showNodeHover(const Node *node)
+{
+    m_hoveredNode = node;
+    m_hoverOverlay->setRect(node->rect());
+    m_hoverOverlay->setPen(node->pen());
+    m_hoverOverlay->setBrush(node->brush());
+    m_hoverOverlay->setPos(node->scenePos());
+    m_hoverOverlay->setVisible(true);
+}
+
+/*
+ * Функция Editor::hideNodeHover - скрытие подсветки узла
+ * Входные параметры:
+ *   node - узел, с которого ушел курсор
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Editor::hideNodeHover(const Node *node)
+{
+    if (m_hoveredNode == node)
+    {
+        m_hoveredNode = nullptr;
+        m_hoverOverlay->setVisible(false);
+    }
+}
+
 /*
  * Функция Editor::showTracingIndicator - отображение индикатора трассировки
  * Входные параметры:
@@ -320,6 +381,7 @@ void Editor::clean()
 {
     m_undoStack.clear();
     TrackGraph::setTrackGraphCount(0);
+    TrackGraph::clear();
     Link::setLinkCount(0);
     Node::setNodeCount(0);
     NotesTool::setNoteCount(0);
@@ -335,9 +397,14 @@ void Editor::clean()
         }
     }
 
+    hideNodeHover(m_hoveredNode);
     m_guideTool->clear();
     m_trackDrawingTool->clean();
 
+    // the removed items must not be found by id or position anymore
+    ItemRegistry::instance().clear();
+    NodeIndex::clear();
+
     // notify all listeners about the scene clean
     CommunicationHub::instance().publish(HubEvent::SCENE_CLEAN, nullptr);
 }
@@ -419,3 +486,134 @@ TrackDrawingTool *Editor::getTrackDrawingTool()
 {
     return m_trackDrawingTool;
 }
+
+/*
+ * Функция Editor::setNetLabelsVisible - включение режима подписей цепей
+ * Входные параметры:
+ *   visible - флаг отображения подписей
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Editor::setNetLabelsVisible(bool visible)
+{
+    if (m_netLabelsVisible == visible)
+    {
+        return;
+    }
+
+    m_netLabelsVisible = visible;
+    if (visible)
+    {
+        m_netLabelFont.setPointSize(12);
+        m_netLabelFont.setBold(true);
+
+        // запас вокруг середины связи, в который помещается любая подпись
+        QFontMetricsF metrics(m_netLabelFont);
+        m_netLabelMargin = qMax(metrics.horizontalAdvance(QStringLiteral("-0000000")), metrics.height()) / 2;
+    }
+    else
+    {
+        // тексты подписей не нужны, пока режим выключен
+        m_netLabels.clear();
+    }
+    m_scene->invalidate(m_scene->sceneRect(), QGraphicsScene::ForegroundLayer);
+}
+
+/*
+ * Функция Editor::netLabel - получение текста подписи цепи
+ * Входные параметры:
+ *   graphId - ID графа (цепи)
+ * Выходные данные:
+ *   подготовленный текст подписи
+ */
+const QStaticText &Editor::netLabel(int graphId)
+{
+    auto it = m_netLabels.find(graphId);
+    if (it == m_netLabels.end())
+    {
+        QStaticText label(QString::number(graphId));
+        label.prepare(QTransform(), m_netLabelFont);
+        it = m_netLabels.insert(graphId, label);
+    }
+    return it.value();
+}
+
+/*
+ * Функция Editor::netLabelRect - область подписи связи
+ * Входные параметры:
+ *   link - связь
+ * Выходные данные:
+ *   прямоугольник в координатах сцены, содержащий подпись
+ */
+QRectF Editor::netLabelRect(const Link *link) const
+{
+    QPointF center = link->mapToScene(link->line().pointAt(0.5));
+    return QRectF(center.x() - m_netLabelMargin, center.y() - m_netLabelMargin,
+                  2 * m_netLabelMargin, 2 * m_netLabelMargin);
+}
+
+/*
+ * Функция Editor::invalidateNetLabel - перерисовка подписи связи
+ * Входные параметры:
+ *   link - связь, у которой изменились положение или цепь
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Editor::invalidateNetLabel(const Link *link)
+{
+    if (m_netLabelsVisible && link->scene() == m_scene)
+    {
+        m_scene->invalidate(netLabelRect(link), QGraphicsScene::ForegroundLayer);
+    }
+}
+
+/*
+ * Функция Editor::drawForeground - отрисовка подписей цепей
+ * Входные параметры:
+ *   painter - художник в координатах сцены
+ *   rect - перерисовываемая область сцены
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Editor::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    ZoomableGraphicsView::drawForeground(painter, rect);
+
+    if (!m_netLabelsVisible)
+    {
+        return;
+    }
+
+    // при сильном уменьшении подписи нечитаемы, поэтому не рисуем их совсем
+    constexpr qreal MinNetLabelPixels = 6;
+    qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    if (lod * m_netLabelMargin < MinNetLabelPixels)
+    {
+        return;
+    }
+
+    QRectF searchRect = rect.adjusted(-m_netLabelMargin, -m_netLabelMargin, m_netLabelMargin, m_netLabelMargin);
+    const QList<QGraphicsItem *> items = m_scene->items(searchRect, Qt::IntersectsItemBoundingRect);
+
+    painter->save();
+    painter->setFont(m_netLabelFont);
+    painter->setPen(QColor("#FFFFFF"));
+    for (QGraphicsItem *item : items)
+    {
+        Link *link = item_cast<Link>(item);
+        if (!link || !link->isVisible() || link->m_graphId < 0)
+        {
+            continue;
+        }
+
+        const QStaticText &label = netLabel(link->m_graphId);
+        QPointF center = link->mapToScene(link->line().pointAt(0.5));
+        QSizeF size = label.size();
+        QPointF topLeft(center.x() - size.width() / 2, center.y() - size.height() / 2);
+        if (rect.intersects(QRectF(topLeft, size)))
+        {
+            painter->drawStaticText(topLeft, label);
+        }
+    }
+    painter->restore();
+}
@@ -11,7 +11,11 @@
 #include <unordered_map>
 #include <vector>
 #include <QStatusBar>
+#include <QStaticText>
+#include <QGraphicsEllipseItem>
+#include <QHash>
 #include "TypeChecks.h"
+#include "ItemRegistry.h"
 
 /*
 #include "component.h"
@@ -30,6 +34,7 @@
 #include "ColorBox.h"
 #include "GuideTool.h"
 #include "TrackDrawingTool.h"
+#include "UndoHistory.h"
 
 /*
  * Класс Editor - основной редактор графической сцены
@@ -63,9 +68,16 @@
  * 26. mouseMoveEvent(QMouseEvent* event) - обработчик движения мыши
  * 27. mouseReleaseEvent(QMouseEvent* event) - обработчик отпускания кнопки мыши
  * 28. addTracingIndicator() - добавление индикатора трассировки
+ * 29. setNetLabelsVisible(bool visible) - включение режима подписей цепей
+ * 30. invalidateNetLabel(const Link* link) - перерисовка подписи связи
+ * 31. drawForeground(QPainter* painter, const QRectF& rect) - отрисовка подписей цепей
+ * 32. showNodeHover(const Node* node) - показ подсветки узла под курсором
+ * 33. hideNodeHover(const Node* node) - скрытие подсветки узла
  */
 class ComponentDrawingTool;
 class NotesTool;
+class Link;
+class Node;
 
 class Editor : public ZoomableGraphicsView
 {
@@ -94,10 +106,16 @@ public:
 	void setStatusBar(QStatusBar *statusBar);
 	void clean();
 	TrackDrawingTool *getTrackDrawingTool();
+	void setNetLabelsVisible(bool visible);
+	bool netLabelsVisible() const { return m_netLabelsVisible; }
+	void invalidateNetLabel(const Link *link);
+	void showNodeHover(const Node *node);
+	void hideNodeHover(const Node *node);
 
 	int padSize;
 	LinkSide m_currentSide;
 	QUndoStack m_undoStack;
+	UndoHistory m_undoHistory;
 	QMap<LinkSide, QGraphicsItemLayer *> m_layers;
 	QGraphicsScene *getScene() const { return m_scene; }
 	DrawingState m_state;
@@ -108,19 +126,7 @@ public:
 	template <typename T>
 	T *findItemByIdAndClass(int itemId)
 	{
-		QList<QGraphicsItem *> items = scene()->items();
-		for (QGraphicsItem *item : items)
-		{
-			if (isDynamicCastableToAny<T>(item))
-			{
-				T *castedItem = dynamic_cast<T *>(item);
-				if (castedItem && castedItem->m_id == itemId)
-				{
-					return castedItem;
-				}
-			}
-		}
-		return nullptr;
+		return ItemRegistry::instance().find<T>(itemId);
 	}
 
 protected:
@@ -131,6 +137,8 @@ protected:
 	void mouseMoveEvent(QMouseEvent *event) override;
 	void mouseReleaseEvent(QMouseEvent *event) override;
 	QGraphicsLineItem *addTracingIndicator();
+	QGraphicsEllipseItem *addHoverOverlay();
+	void drawForeground(QPainter *painter, const QRectF &rect) override;
 
 private:
 	static Editor *m_instance;
@@ -141,6 +149,20 @@ private:
 
 	QStatusBar *m_statusBar;
 
+	// One shared item shows the hovered node, so hovering repaints only its rect
+	QGraphicsEllipseItem *m_hoverOverlay;
+	const Node *m_hoveredNode = nullptr;
+
+	// Net labels are not scene items: they are drawn in one pass over the
+	// visible links, and their texts only exist while the mode is on
+	const QStaticText &netLabel(int graphId);
+	QRectF netLabelRect(const Link *link) const;
+
+	bool m_netLabelsVisible = false;
+	QFont m_netLabelFont;
+	qreal m_netLabelMargin = 0;
+	QHash<int, QStaticText> m_netLabels;
+
 	/*QObject* currentEditor;
 
 	QJsonObject getSceneElements();
@@ -1,9 +1,9 @@
 #include <QGraphicsScene>
 #include <QPixmap>
-#include <iostream>
 #include "GuideTool.h"
 #include "ImageLayer.h"
 #include "Editor.h"
+#include "Trace.h"
 
 
 GuideTool::GuideTool() {}
@@ -12,7 +12,7 @@ GuideTool::~GuideTool() {
     // get all items and remove the ones of type ImageLayer
     auto items = Editor::instance()->scene()->items();
     for (auto item : items) {
-        if (dynamic_cast<ImageLayer*>(item)) {
+        if (item->type() == ImageLayer::Type) {
             Editor::instance()->scene()->removeItem(item);
             delete item;
         }
@@ -37,25 +37,27 @@ void GuideTool::onMouseMove(QMouseEvent* event) {
 
 void GuideTool::setLayerOpacity(LinkSide side, qreal alpha) {
     int layerId = static_cast<int>(side);
-    ImageLayer* layer = dynamic_cast<ImageLayer*>(Editor::instance()->findItemByIdAndClass<ImageLayer>(layerId));
+    ImageLayer* layer = Editor::instance()->findItemByIdAndClass<ImageLayer>(layerId);
     if (layer != nullptr) {
         layer->setOpacity(alpha);
     }
 }
 
 void GuideTool::clear() {
-    // get all items and remove the ones of type ImageLayer
+    // get all items and delete the ones of type ImageLayer; deleting a layer stops
+    // its pyramid build, so a reopened project never shares the tile cache with it
     auto items = Editor::instance()->scene()->items();
     for (auto item : items) {
-        if (dynamic_cast<ImageLayer*>(item)) {
+        if (item->type() == ImageLayer::Type) {
             Editor::instance()->scene()->removeItem(item);
+            delete item;
         }
     }
 }
 
 void GuideTool::setImageLayer(LinkSide side, const QString& imagePath) {
     int layerId = static_cast<int>(side);
-    ImageLayer* layer = dynamic_cast<ImageLayer*>(Editor::instance()->findItemByIdAndClass<ImageLayer>(layerId));
+    ImageLayer* layer = Editor::instance()->findItemByIdAndClass<ImageLayer>(layerId);
     if (layer == nullptr) {
         layer = new ImageLayer(static_cast<int>(side));
         switch (side) {
@@ -73,10 +75,8 @@ void GuideTool::setImageLayer(LinkSide side, const QString& imagePath) {
                 break;
         }
 
-        layer->loadImage(imagePath);
-
         Editor::instance()->scene()->addItem(layer);
     }
-    std::cout << "layer image " << layer << std::endl;
+    PCB_TRACE(lcTools) << "layer image" << layer;
     layer->loadImage(imagePath);
 }
\ No newline at end of file
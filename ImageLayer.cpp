@@ -1,35 +1,94 @@
 #include "ImageLayer.h"
-#include <QPixmap>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QDebug>
+#include <cmath>
+#include "ItemRegistry.h"
 
-ImageLayer::ImageLayer(int id) : QGraphicsPixmapItem(), m_id(id)
+ImageLayer::ImageLayer(int id) : QGraphicsItem(), m_id(id)
 {
     setZValue(-1); // Устанавливаем слой позади других элементов
     setPos(0, 0);  // Позиционируем изображение в левом верхнем углу
     setOpacity(1); // Устанавливаем непрозрачность 100%
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption); // Нужен exposedRect для выбора тайлов
+    ItemRegistry::instance().add<ImageLayer>(m_id, this);
+
+    // Перерисовываем слой, когда превью или пирамида готовы
+    QObject::connect(&m_pyramid, &ImagePyramid::previewReady, &m_pyramid, [this]()
+                     { update(); });
+    QObject::connect(&m_pyramid, &ImagePyramid::ready, &m_pyramid, [this]()
+                     { update(); });
+}
+
+ImageLayer::~ImageLayer()
+{
+    ItemRegistry::instance().remove<ImageLayer>(m_id, this);
 }
 
 bool ImageLayer::loadImage(const QString &imagePath)
 {
     m_imagePath = imagePath;
 
-    // Загружаем изображение
-    QPixmap pixmap;
-    if (!pixmap.load(imagePath))
+    // Открываем пирамиду: читается только заголовок, тайлы строятся в фоне при необходимости
+    prepareGeometryChange();
+    if (!m_pyramid.open(imagePath))
     {
         qDebug() << "Failed to load image:" << imagePath;
         return false;
     }
+    update();
+    return true;
+}
+
+QRectF ImageLayer::boundingRect() const
+{
+    return QRectF(QPointF(0, 0), m_pyramid.size());
+}
+
+void ImageLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+    if (!m_pyramid.isReady())
+    {
+        // Пока строится пирамида, показываем растянутое превью
+        QPixmap preview = m_pyramid.preview();
+        if (!preview.isNull())
+        {
+            painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+            painter->drawPixmap(boundingRect(), preview, QRectF(preview.rect()));
+        }
+        return;
+    }
 
-    // Устанавливаем изображение в слой
-    if (!pixmap.isNull())
+    // Уровень пирамиды по текущему масштабу
+    const qreal scale = option->levelOfDetailFromTransform(painter->worldTransform());
+    const int level = m_pyramid.levelForScale(scale);
+    const qreal tileSpan = qreal(ImagePyramid::TileSize << level); // Сторона тайла в координатах слоя
+
+    // Диапазон тайлов, попадающих в видимую область
+    QRectF exposed = option->exposedRect.intersected(boundingRect());
+    if (exposed.isEmpty())
     {
-        setPixmap(pixmap);
-        return true;
+        return;
     }
-    else
+    const int firstX = int(std::floor(exposed.left() / tileSpan));
+    const int lastX = int(std::ceil(exposed.right() / tileSpan)) - 1;
+    const int firstY = int(std::floor(exposed.top() / tileSpan));
+    const int lastY = int(std::ceil(exposed.bottom() / tileSpan)) - 1;
+    m_pyramid.reserveTiles((lastX - firstX + 1) * (lastY - firstY + 1));
+
+    painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+    for (int y = firstY; y <= lastY; ++y)
     {
-        qDebug() << "Failed to load image:" << imagePath;
-        return false;
+        for (int x = firstX; x <= lastX; ++x)
+        {
+            QPixmap tile = m_pyramid.tile(level, x, y);
+            if (tile.isNull())
+            {
+                continue;
+            }
+            QRectF target(x * tileSpan, y * tileSpan, tile.width() << level, tile.height() << level);
+            painter->drawPixmap(target, tile, QRectF(tile.rect()));
+        }
     }
 }
@@ -1,16 +1,20 @@
 #ifndef IMAGELAYER_H
 #define IMAGELAYER_H
 
-#include <QGraphicsPixmapItem>
+#include <QGraphicsItem>
 #include <QString>
+#include "ImagePyramid.h"
+#include "TypeChecks.h"
 
 /**
  * @brief Класс слоя изображения
  *
  * ImageLayer представляет собой слой изображения на печатной плате,
  * который может содержать изображение лицевой или обратной стороны платы.
+ * Изображение отрисовывается тайлами из ImagePyramid: рисуются только тайлы,
+ * попадающие в видимую область, с уровня, соответствующего текущему масштабу.
  */
-class ImageLayer : public QGraphicsPixmapItem
+class ImageLayer : public QGraphicsItem
 {
 public:
     /**
@@ -19,6 +23,21 @@ public:
      */
     explicit ImageLayer(int id);
 
+    enum { Type = ImageLayerItem, LastType = Type }; ///< Тип элемента для item_cast
+
+    /**
+     * @brief Возвращает тип элемента сцены
+     * @return ImageLayer::Type
+     */
+    int type() const override { return Type; }
+
+    /**
+     * @brief Деструктор слоя изображения
+     *
+     * Удаляет слой из реестра элементов
+     */
+    ~ImageLayer();
+
     /**
      * @brief Загружает изображение в слой
      * @param imagePath Путь к файлу изображения
@@ -26,8 +45,25 @@ public:
      */
     bool loadImage(const QString &imagePath);
 
+    /**
+     * @brief Возвращает ограничивающий прямоугольник слоя (размер изображения)
+     * @return Ограничивающий прямоугольник
+     */
+    QRectF boundingRect() const override;
+
+    /**
+     * @brief Отрисовывает видимые тайлы изображения
+     * @param painter Указатель на объект QPainter
+     * @param option Параметры стиля (используется exposedRect)
+     * @param widget Указатель на виджет
+     */
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
     int m_id;            ///< Уникальный идентификатор слоя
     QString m_imagePath; ///< Путь к файлу изображения
+
+private:
+    ImagePyramid m_pyramid; ///< Тайловая пирамида изображения
 };
 
-#endif // IMAGELAYER_H
\ No newline at end of file
+#endif // IMAGELAYER_H
@@ -0,0 +1,441 @@
+#include "ImagePyramid.h"
+#include <QImageReader>
+#include <QImage>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QPainter>
+#include <QtConcurrent>
+#include <QDebug>
+#include <cmath>
+
+namespace
+{
+/// Версия раскладки кэша; при изменении старые кэши перестраиваются
+constexpr int CacheVersion = 2;
+
+/*
+ * Отпечаток исходного файла: кэш считается актуальным, пока он не изменился
+ */
+QString sourceStamp(const QString &imagePath)
+{
+    QFileInfo info(imagePath);
+    return QString("%1:%2:%3").arg(CacheVersion).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch());
+}
+
+/*
+ * Путь к файлу тайла; уровень 0 хранится без потерь
+ */
+QString tileFile(const QString &cacheDir, const QString &tileFormat, int level, int x, int y)
+{
+    return QString("%1/%2_%3_%4.%5").arg(cacheDir).arg(level).arg(x).arg(y).arg(level == 0 ? "png" : tileFormat);
+}
+
+/*
+ * Сохранение тайла: PNG без потерь, JPEG с качеством 90
+ */
+bool saveTile(const QImage &tile, const QString &path)
+{
+    bool jpeg = path.endsWith(".jpg");
+    return tile.save(path, jpeg ? "jpg" : "png", jpeg ? 90 : -1);
+}
+
+quint64 tileKey(int level, int x, int y)
+{
+    return (quint64(level) << 48) | (quint64(y) << 24) | quint64(x);
+}
+
+int tileCost(const QPixmap &pixmap)
+{
+    return qMax(1, int(qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8 / 1024));
+}
+} // namespace
+
+QString ImagePyramid::m_projectPath;
+
+ImagePyramid::ImagePyramid(QObject *parent) : QObject(parent)
+{
+    m_tiles.setMaxCost(MinCachedTiles * TileSize * TileSize * 4 / 1024);
+    connect(&m_builder, &QFutureWatcher<bool>::finished, this, [this]()
+            {
+        if (m_builder.isCanceled() || !m_builder.result())
+        {
+            qDebug() << "Failed to build image pyramid for" << m_imagePath;
+            return;
+        }
+        m_tiles.clear();
+        m_preview = QPixmap(); // тайлы заменяют превью
+        m_ready = true;
+        emit ready(); });
+
+    connect(&m_previewLoader, &QFutureWatcher<QImage>::finished, this, [this]()
+            { setPreview(m_previewLoader.result()); });
+}
+
+ImagePyramid::~ImagePyramid()
+{
+    cancelBuild();
+}
+
+void ImagePyramid::cancelBuild()
+{
+    m_cancelled = true;
+    m_builder.waitForFinished();
+    m_cancelled = false;
+}
+
+void ImagePyramid::setPreview(const QImage &image)
+{
+    if (!m_ready && !image.isNull())
+    {
+        m_preview = QPixmap::fromImage(image);
+        emit previewReady();
+    }
+}
+
+bool ImagePyramid::open(const QString &imagePath)
+{
+    cancelBuild();
+    m_tiles.clear();
+    m_preview = QPixmap();
+    m_ready = false;
+    m_imagePath = imagePath;
+    ++m_generation;
+
+    // Читаем только заголовок: размер и формат пикселей
+    QImageReader reader(imagePath);
+    m_size = reader.size();
+    if (!m_size.isValid())
+    {
+        qDebug() << "Failed to read image size:" << imagePath << reader.errorString();
+        m_size = QSize();
+        m_levelCount = 0;
+        return false;
+    }
+
+    // Число уровней: до уровня, целиком помещающегося в один тайл
+    m_levelCount = 1;
+    for (int side = qMax(m_size.width(), m_size.height()); side > TileSize; side = (side + 1) / 2)
+    {
+        ++m_levelCount;
+    }
+
+    // Уменьшенные уровни сканов без прозрачности хранятся в JPEG, остальные - в PNG
+    QImage::Format format = reader.imageFormat();
+    bool hasAlpha = format != QImage::Format_Invalid && QImage(1, 1, format).hasAlphaChannel();
+    m_tileFormat = hasAlpha ? "png" : "jpg";
+
+    m_cacheDir = cacheDirFor(imagePath);
+
+    // Используем дисковый кэш, если он построен для этого же файла
+    QString stamp = sourceStamp(imagePath);
+    QSettings cacheInfo(QDir(m_cacheDir).absoluteFilePath("pyramid.ini"), QSettings::IniFormat);
+    if (cacheInfo.value("stamp").toString() == stamp && cacheInfo.value("format").toString() == m_tileFormat &&
+        cacheInfo.value("levels").toInt() == m_levelCount)
+    {
+        m_ready = true;
+        return true;
+    }
+
+    // Декодеры без чтения части изображения (PNG, TIFF) разбирают файл целиком.
+    // Предел выделения памяти QImageReader (256 МБ) поднимается до размера скана.
+    QSize previewSize = m_size.scaled(QSize(PreviewSize, PreviewSize), Qt::KeepAspectRatio).boundedTo(m_size);
+    BuildJob job{imagePath, m_cacheDir, m_tileFormat, m_size, m_levelCount, hasAlpha,
+                 reader.supportsOption(QImageIOHandler::ClipRect), stamp, previewSize};
+    if (!job.clipDecode && QImageReader::allocationLimit() > 0)
+    {
+        int depth = format != QImage::Format_Invalid ? QImage(1, 1, format).depth() : 32;
+        int requiredMb = int(qint64(m_size.width()) * m_size.height() * qMax(depth, 32) / 8 / (1024 * 1024)) + 1;
+        QImageReader::setAllocationLimit(qMax(QImageReader::allocationLimit(), requiredMb));
+    }
+
+    // Превью появляется раньше, чем будет построена пирамида. JPEG уменьшается при
+    // декодировании, остальные форматы отдают превью из полного декодирования построения.
+    PreviewCallback preview;
+    if (job.clipDecode)
+    {
+        m_previewLoader.setFuture(QtConcurrent::run(&ImagePyramid::decodePreview, imagePath, previewSize));
+    }
+    else
+    {
+        const int generation = m_generation;
+        preview = [this, generation](const QImage &image)
+        {
+            // Вызывается в рабочем потоке; объект жив, пока построение не завершено
+            QMetaObject::invokeMethod(this, [this, generation, image]()
+                                      {
+                if (generation == m_generation)
+                {
+                    setPreview(image);
+                } }, Qt::QueuedConnection);
+        };
+    }
+
+    QDir().mkpath(m_cacheDir);
+    m_builder.setFuture(QtConcurrent::run(&ImagePyramid::build, job, &m_cancelled, preview));
+    return true;
+}
+
+void ImagePyramid::setProjectPath(const QString &projectPath)
+{
+    m_projectPath = projectPath;
+}
+
+/*
+ * Функция ImagePyramid::cacheDirFor - каталог кэша тайлов изображения
+ * Входные параметры:
+ *   imagePath - путь к исходному изображению
+ * Выходные данные:
+ *   QString - каталог рядом с проектом (или в кэше приложения, если проект не сохранен)
+ */
+QString ImagePyramid::cacheDirFor(const QString &imagePath)
+{
+    QString root;
+    if (!m_projectPath.isEmpty())
+    {
+        QFileInfo project(m_projectPath);
+        root = project.dir().absoluteFilePath("." + project.fileName() + ".tiles");
+    }
+    else
+    {
+        root = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/tiles";
+    }
+
+    // Сканы с одинаковыми именами из разных каталогов не должны делить кэш
+    QFileInfo image(imagePath);
+    QByteArray pathHash = QCryptographicHash::hash(image.absoluteFilePath().toUtf8(), QCryptographicHash::Sha1).toHex().left(8);
+    return QDir(root).absoluteFilePath(image.fileName() + "-" + QString::fromLatin1(pathHash));
+}
+
+int ImagePyramid::levelForScale(qreal scale) const
+{
+    if (scale <= 0 || m_levelCount == 0)
+    {
+        return 0;
+    }
+    int level = int(std::floor(std::log2(1.0 / scale)));
+    return qBound(0, level, m_levelCount - 1);
+}
+
+QPixmap ImagePyramid::tile(int level, int x, int y)
+{
+    if (!m_ready)
+    {
+        return QPixmap();
+    }
+
+    quint64 key = tileKey(level, x, y);
+    if (QPixmap *cached = m_tiles.object(key))
+    {
+        return *cached;
+    }
+
+    QPixmap pixmap(tilePath(level, x, y));
+    if (!pixmap.isNull())
+    {
+        m_tiles.insert(key, new QPixmap(pixmap), tileCost(pixmap));
+    }
+    return pixmap;
+}
+
+void ImagePyramid::reserveTiles(int visibleTiles)
+{
+    int tiles = qMax(MinCachedTiles, visibleTiles * 2);
+    m_tiles.setMaxCost(tiles * TileSize * TileSize * 4 / 1024);
+}
+
+QString ImagePyramid::tilePath(int level, int x, int y) const
+{
+    return tileFile(m_cacheDir, m_tileFormat, level, x, y);
+}
+
+/*
+ * Функция ImagePyramid::decodePreview - декодирование уменьшенного превью (выполняется в рабочем потоке)
+ * Входные параметры:
+ *   imagePath - путь к исходному изображению
+ *   size - размер превью
+ * Выходные данные:
+ *   QImage - превью (пустое при ошибке)
+ */
+QImage ImagePyramid::decodePreview(const QString &imagePath, const QSize &size)
+{
+    // Вызывается только для декодеров, которые уменьшают изображение при чтении (JPEG):
+    // полное изображение не создается
+    QImageReader reader(imagePath);
+    reader.setScaledSize(size);
+    return reader.read();
+}
+
+/*
+ * Функция ImagePyramid::build - построение пирамиды (выполняется в рабочем потоке)
+ * Входные параметры:
+ *   job - параметры построения
+ *   cancelled - флаг прерывания
+ *   preview - получатель превью из полного декодирования (может быть пустым)
+ * Выходные данные:
+ *   bool - true, если все тайлы записаны
+ */
+bool ImagePyramid::build(const BuildJob &job, const std::atomic<bool> *cancelled, const PreviewCallback &preview)
+{
+    // Отпечаток пишется последним, поэтому прерванное построение не примется за готовый кэш
+    QSettings cacheInfo(QDir(job.cacheDir).absoluteFilePath("pyramid.ini"), QSettings::IniFormat);
+    cacheInfo.remove("stamp");
+    cacheInfo.sync();
+
+    if (!buildBaseLevel(job, cancelled, preview))
+    {
+        return false;
+    }
+
+    // Каждый следующий уровень собирается из уже записанных тайлов предыдущего
+    QSize levelSize = job.size;
+    for (int l = 1; l < job.levelCount; ++l)
+    {
+        if (!buildLevel(job, l, levelSize, cancelled))
+        {
+            return false;
+        }
+        levelSize = QSize((levelSize.width() + 1) / 2, (levelSize.height() + 1) / 2);
+    }
+
+    cacheInfo.setValue("format", job.tileFormat);
+    cacheInfo.setValue("levels", job.levelCount);
+    cacheInfo.setValue("stamp", job.stamp);
+    cacheInfo.sync();
+    return cacheInfo.status() == QSettings::NoError;
+}
+
+/*
+ * Функция ImagePyramid::buildBaseLevel - запись тайлов уровня 0
+ *
+ * Если декодер умеет читать часть изображения, исходный файл читается полосами
+ * высотой в целое число тайлов, не больше BandBytes на полосу. Иначе изображение
+ * декодируется один раз целиком и освобождается сразу после записи уровня 0.
+ * Входные параметры:
+ *   job - параметры построения
+ *   cancelled - флаг прерывания
+ *   preview - получатель превью из полного декодирования (может быть пустым)
+ * Выходные данные:
+ *   bool - true, если все тайлы записаны
+ */
+bool ImagePyramid::buildBaseLevel(const BuildJob &job, const std::atomic<bool> *cancelled, const PreviewCallback &preview)
+{
+    const int width = job.size.width();
+    const int height = job.size.height();
+
+    // Записывает тайлы, целиком лежащие в полосе band, начинающейся со строки top
+    auto writeBand = [&](const QImage &band, int top)
+    {
+        const int tileY = top / TileSize;
+        for (int y = 0; y * TileSize < band.height(); ++y)
+        {
+            for (int x = 0; x * TileSize < width; ++x)
+            {
+                if (cancelled->load())
+                {
+                    return false;
+                }
+                QImage tile = band.copy(x * TileSize, y * TileSize,
+                                        qMin(TileSize, width - x * TileSize),
+                                        qMin(TileSize, band.height() - y * TileSize));
+                if (!saveTile(tile, tileFile(job.cacheDir, job.tileFormat, 0, x, tileY + y)))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    };
+
+    if (!job.clipDecode)
+    {
+        QImageReader reader(job.imagePath);
+        QImage image = reader.read();
+        if (image.isNull())
+        {
+            qDebug() << "Failed to decode" << job.imagePath << reader.errorString();
+            return false;
+        }
+        if (preview)
+        {
+            preview(image.scaled(job.previewSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+        }
+        return writeBand(image, 0);
+    }
+
+    const qint64 rowBytes = qint64(width) * 4;
+    const int bandRows = int(qMax<qint64>(1, BandBytes / rowBytes / TileSize)) * TileSize;
+    for (int top = 0; top < height; top += bandRows)
+    {
+        QImageReader reader(job.imagePath);
+        reader.setClipRect(QRect(0, top, width, qMin(bandRows, height - top)));
+        QImage band = reader.read();
+        if (band.isNull())
+        {
+            qDebug() << "Failed to decode" << job.imagePath << reader.errorString();
+            return false;
+        }
+        if (!writeBand(band, top))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Функция ImagePyramid::buildLevel - запись тайлов уменьшенного уровня
+ *
+ * Тайл (x, y) уровня получается уменьшением вдвое четырех тайлов (2x..2x+1, 2y..2y+1)
+ * предыдущего уровня, прочитанных с диска; в памяти одновременно не больше четырех тайлов.
+ * Входные параметры:
+ *   job - параметры построения
+ *   level - номер уровня (больше 0)
+ *   parentSize - размер предыдущего уровня
+ *   cancelled - флаг прерывания
+ * Выходные данные:
+ *   bool - true, если все тайлы записаны
+ */
+bool ImagePyramid::buildLevel(const BuildJob &job, int level, const QSize &parentSize, const std::atomic<bool> *cancelled)
+{
+    const int span = TileSize * 2; // Сторона тайла в пикселях предыдущего уровня
+    for (int y = 0; y * span < parentSize.height(); ++y)
+    {
+        for (int x = 0; x * span < parentSize.width(); ++x)
+        {
+            if (cancelled->load())
+            {
+                return false;
+            }
+            QImage quad(qMin(span, parentSize.width() - x * span), qMin(span, parentSize.height() - y * span),
+                        job.hasAlpha ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+            quad.fill(Qt::transparent);
+            {
+                QPainter painter(&quad);
+                painter.setCompositionMode(QPainter::CompositionMode_Source);
+                for (int dy = 0; dy < 2 && dy * TileSize < quad.height(); ++dy)
+                {
+                    for (int dx = 0; dx < 2 && dx * TileSize < quad.width(); ++dx)
+                    {
+                        QImage part(tileFile(job.cacheDir, job.tileFormat, level - 1, x * 2 + dx, y * 2 + dy));
+                        if (part.isNull())
+                        {
+                            return false;
+                        }
+                        painter.drawImage(dx * TileSize, dy * TileSize, part);
+                    }
+                }
+            }
+            QImage tile = quad.scaled((quad.width() + 1) / 2, (quad.height() + 1) / 2,
+                                      Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            if (!saveTile(tile, tileFile(job.cacheDir, job.tileFormat, level, x, y)))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
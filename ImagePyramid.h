@@ -0,0 +1,179 @@
+#ifndef IMAGEPYRAMID_H
+#define IMAGEPYRAMID_H
+
+#include <QObject>
+#include <QString>
+#include <QSize>
+#include <QPixmap>
+#include <QImage>
+#include <QCache>
+#include <QFutureWatcher>
+#include <atomic>
+#include <functional>
+
+/**
+ * @brief Тайловая пирамида уровней детализации для изображения платы
+ *
+ * Уровень 0 - исходное разрешение, каждый следующий уровень уменьшен вдвое.
+ * Каждый уровень разрезан на тайлы TileSize x TileSize. Пирамида строится один раз
+ * в рабочем потоке и сохраняется на диск рядом с проектом (".<имя проекта>.tiles",
+ * подкаталог на каждое изображение). При следующем открытии кэш используется,
+ * если исходный файл не изменился. В памяти хранятся только недавно отрисованные
+ * тайлы, их число ограничивается размером видимой области.
+ *
+ * Уровень 0 хранится без потерь (PNG). Уменьшенные уровни сканов без прозрачности
+ * хранятся в JPEG, остальные - в PNG.
+ *
+ * Пока пирамида строится, вместо тайлов отображается уменьшенное превью (не больше
+ * PreviewSize по длинной стороне). Если декодер умеет уменьшать при чтении (JPEG),
+ * превью декодируется отдельно; иначе его получает построение пирамиды из того же
+ * единственного полного декодирования.
+ */
+class ImagePyramid : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int TileSize = 512;     ///< Размер стороны тайла в пикселях
+    static constexpr int PreviewSize = 2048; ///< Длинная сторона превью в пикселях
+    static constexpr qint64 BandBytes = 64 * 1024 * 1024; ///< Память под полосу исходного изображения при построении
+
+    /**
+     * @brief Конструктор пирамиды
+     * @param parent Родительский объект
+     */
+    explicit ImagePyramid(QObject *parent = nullptr);
+
+    /**
+     * @brief Деструктор пирамиды
+     *
+     * Прерывает построение, если оно еще идет
+     */
+    ~ImagePyramid();
+
+    /**
+     * @brief Открывает изображение
+     *
+     * Читает только заголовок файла. Если дискового кэша нет или он устарел,
+     * запускает построение пирамиды в рабочем потоке; по завершении испускается ready().
+     * @param imagePath Путь к файлу изображения
+     * @return true если размер изображения удалось определить
+     */
+    bool open(const QString &imagePath);
+
+    /**
+     * @brief Устанавливает путь к файлу проекта
+     *
+     * Кэш тайлов изображений, открытых после вызова, строится рядом с проектом.
+     * Пока проект не сохранен, кэш размещается в каталоге кэша приложения.
+     * @param projectPath Путь к файлу проекта (пустой, если проект не сохранен)
+     */
+    static void setProjectPath(const QString &projectPath);
+
+    /**
+     * @brief Размер изображения на уровне 0
+     */
+    QSize size() const { return m_size; }
+
+    /**
+     * @brief Число уровней пирамиды
+     */
+    int levelCount() const { return m_levelCount; }
+
+    /**
+     * @brief Готова ли пирамида к отрисовке
+     */
+    bool isReady() const { return m_ready; }
+
+    /**
+     * @brief Уменьшенное превью изображения
+     * @return Превью или пустой QPixmap, если оно еще не декодировано или пирамида уже готова
+     */
+    QPixmap preview() const { return m_preview; }
+
+    /**
+     * @brief Подбирает уровень для масштаба отображения
+     * @param scale Число экранных пикселей на пиксель изображения
+     * @return Номер уровня, разрешение которого не ниже требуемого
+     */
+    int levelForScale(qreal scale) const;
+
+    /**
+     * @brief Возвращает тайл уровня
+     *
+     * Вызывается из GUI-потока. Тайл берется из кэша в памяти или читается с диска.
+     * @param level Номер уровня
+     * @param x Номер столбца тайла
+     * @param y Номер строки тайла
+     * @return Тайл или пустой QPixmap, если пирамида еще не готова
+     */
+    QPixmap tile(int level, int x, int y);
+
+    /**
+     * @brief Устанавливает размер кэша тайлов в памяти
+     *
+     * Кэш вмещает вдвое больше тайлов, чем видно одновременно, но не меньше MinCachedTiles.
+     * @param visibleTiles Число тайлов, видимых в окне просмотра
+     */
+    void reserveTiles(int visibleTiles);
+
+signals:
+    /**
+     * @brief Пирамида построена и готова к отрисовке
+     */
+    void ready();
+
+    /**
+     * @brief Превью декодировано и может быть отображено
+     */
+    void previewReady();
+
+private:
+    static constexpr int MinCachedTiles = 16; ///< Минимальная емкость кэша тайлов
+
+    /**
+     * @brief Параметры построения пирамиды в рабочем потоке
+     */
+    struct BuildJob
+    {
+        QString imagePath;  ///< Путь к исходному изображению
+        QString cacheDir;   ///< Каталог для тайлов
+        QString tileFormat; ///< Формат тайлов уменьшенных уровней
+        QSize size;         ///< Размер изображения на уровне 0
+        int levelCount;     ///< Число уровней
+        bool hasAlpha;      ///< Изображение с прозрачностью
+        bool clipDecode;    ///< Декодер умеет читать часть изображения (QImageIOHandler::ClipRect)
+        QString stamp;      ///< Отпечаток исходного файла
+        QSize previewSize;  ///< Размер превью, получаемого при полном декодировании
+    };
+
+    /// Получатель превью из рабочего потока
+    using PreviewCallback = std::function<void(const QImage &)>;
+
+    void cancelBuild();
+    void setPreview(const QImage &image);
+    QString tilePath(int level, int x, int y) const;
+    static QString cacheDirFor(const QString &imagePath);
+
+    static QImage decodePreview(const QString &imagePath, const QSize &size);
+    static bool build(const BuildJob &job, const std::atomic<bool> *cancelled, const PreviewCallback &preview);
+    static bool buildBaseLevel(const BuildJob &job, const std::atomic<bool> *cancelled, const PreviewCallback &preview);
+    static bool buildLevel(const BuildJob &job, int level, const QSize &parentSize, const std::atomic<bool> *cancelled);
+
+    static QString m_projectPath;      ///< Путь к файлу текущего проекта
+
+    QString m_imagePath;               ///< Путь к исходному изображению
+    QString m_cacheDir;                ///< Каталог дискового кэша тайлов
+    QString m_tileFormat;              ///< Формат тайлов уменьшенных уровней ("jpg" или "png")
+    QSize m_size;                      ///< Размер изображения на уровне 0
+    int m_levelCount = 0;              ///< Число уровней
+    bool m_ready = false;              ///< Пирамида готова к отрисовке
+    QCache<quint64, QPixmap> m_tiles;  ///< Тайлы в памяти (стоимость - КБ)
+    QPixmap m_preview;                 ///< Превью на время построения пирамиды
+    QFutureWatcher<bool> m_builder;    ///< Построение пирамиды в рабочем потоке
+    QFutureWatcher<QImage> m_previewLoader; ///< Декодирование превью в рабочем потоке
+    std::atomic<bool> m_cancelled{false}; ///< Запрос на прерывание построения
+    int m_generation = 0;              ///< Номер открытия; превью прежнего изображения отбрасывается
+};
+
+#endif // IMAGEPYRAMID_H
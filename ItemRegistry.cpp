@@ -0,0 +1,17 @@
+#include "ItemRegistry.h"
+
+ItemRegistry &ItemRegistry::instance()
+{
+    static ItemRegistry instance;
+    return instance;
+}
+
+void ItemRegistry::clear()
+{
+    m_nodes.clear();
+    m_pads.clear();
+    m_links.clear();
+    m_components.clear();
+    m_notes.clear();
+    m_imageLayers.clear();
+}
@@ -0,0 +1,128 @@
+#ifndef ITEMREGISTRY_H
+#define ITEMREGISTRY_H
+
+#include <unordered_map>
+#include <type_traits>
+
+class Node;
+class Pad;
+class Link;
+class Component;
+class TextNote;
+class ImageLayer;
+
+/**
+ * @brief Реестр элементов сцены, индексированный по (типу, ID)
+ *
+ * ItemRegistry реализует паттерн Singleton и заменяет линейный обход
+ * scene()->items() при поиске элемента по идентификатору. Элементы
+ * регистрируются в конструкторах и при повторном добавлении на сцену,
+ * и удаляются из реестра в деструкторах, Link::remove, Component::remove
+ * и Editor::clean.
+ */
+class ItemRegistry
+{
+public:
+    /**
+     * @brief Получает экземпляр реестра (Singleton)
+     * @return Ссылка на экземпляр ItemRegistry
+     */
+    static ItemRegistry &instance();
+
+    /**
+     * @brief Регистрирует элемент под указанным ID
+     * @param id Идентификатор элемента
+     * @param item Указатель на элемент
+     */
+    template <typename T>
+    void add(int id, T *item)
+    {
+        items<T>()[id] = item;
+    }
+
+    /**
+     * @brief Удаляет элемент из реестра
+     *
+     * Запись удаляется только если под этим ID зарегистрирован именно этот элемент.
+     * @param id Идентификатор элемента
+     * @param item Указатель на элемент
+     */
+    template <typename T>
+    void remove(int id, T *item)
+    {
+        auto &map = items<T>();
+        auto it = map.find(id);
+        if (it != map.end() && it->second == item)
+        {
+            map.erase(it);
+        }
+    }
+
+    /**
+     * @brief Ищет элемент по ID
+     *
+     * Возвращает только элементы, находящиеся на сцене, так же как прежний обход scene()->items().
+     * @param id Идентификатор элемента
+     * @return Указатель на элемент или nullptr
+     */
+    template <typename T>
+    T *find(int id)
+    {
+        auto &map = items<T>();
+        auto it = map.find(id);
+        if (it == map.end() || it->second->scene() == nullptr)
+        {
+            return nullptr;
+        }
+        return it->second;
+    }
+
+    /**
+     * @brief Возвращает все зарегистрированные элементы указанного типа
+     * @return Словарь ID -> элемент
+     */
+    template <typename T>
+    const std::unordered_map<int, T *> &all()
+    {
+        return items<T>();
+    }
+
+    /**
+     * @brief Очищает реестр
+     */
+    void clear();
+
+private:
+    ItemRegistry() = default;
+    ItemRegistry(const ItemRegistry &) = delete;
+    ItemRegistry &operator=(const ItemRegistry &) = delete;
+
+    template <typename T>
+    std::unordered_map<int, T *> &items()
+    {
+        if constexpr (std::is_same_v<T, Pad>)
+            return m_pads;
+        else if constexpr (std::is_same_v<T, Node>)
+            return m_nodes;
+        else if constexpr (std::is_same_v<T, Link>)
+            return m_links;
+        else if constexpr (std::is_same_v<T, Component>)
+            return m_components;
+        else if constexpr (std::is_same_v<T, TextNote>)
+            return m_notes;
+        else
+        {
+            static_assert(std::is_same_v<T, ImageLayer>, "ItemRegistry: unsupported item type");
+            return m_imageLayers;
+        }
+    }
+
+    std::unordered_map<int, Node *> m_nodes;             ///< Узлы и контакты (общий счетчик ID)
+    std::unordered_map<int, Pad *> m_pads;               ///< Контакты компонентов
+    std::unordered_map<int, Link *> m_links;             ///< Связи
+    std::unordered_map<int, Component *> m_components;   ///< Компоненты
+    std::unordered_map<int, TextNote *> m_notes;         ///< Текстовые заметки
+    std::unordered_map<int, ImageLayer *> m_imageLayers; ///< Слои изображений
+};
+
+#endif // ITEMREGISTRY_H
@@ -2,11 +2,9 @@
 #include "Node.h"
 #include "Editor.h"
 #include "Config.h"
-
-/*
- * Статическая переменная TrackGraph::count - счетчик графов трассировки
- */
-int TrackGraph::count = 0;
+#include "ItemRegistry.h"
+#include "Trace.h"
+#include "QGraphicsItemLayer.h"
 
 /*
  * Статическая переменная Link::link_count - счетчик связей
@@ -22,19 +20,9 @@ int Link::link_count = 0;
  */
 Link::Link(int id) : QGraphicsLineItem(), m_id(id), m_graphId(-1), m_my_from_node(nullptr), m_my_to_node(nullptr), m_side(LinkSide::FRONT)
 {
-    Editor *editor = Editor::instance();
-
-    m_text_item = new QGraphicsSimpleTextItem(QString::number(m_graphId), this);
-    m_text_item->setBrush(QColor("#FFFFFF"));
-    m_text_item->setZValue(1);
-
-    QFont font;
-    font.setPointSize(12);
-    font.setBold(true);
-    m_text_item->setFont(font);
-    m_text_item->setVisible(false);
-    editor->scene()->addItem(m_text_item);
-    updateTextPosition();
+    // трассу рисует слой связи, см. syncTrack
+    setFlag(QGraphicsItem::ItemHasNoContents);
+    ItemRegistry::instance().add<Link>(m_id, this);
 }
 
 /*
@@ -46,25 +34,23 @@ Link::Link(int id) : QGraphicsLineItem(), m_id(id), m_graphId(-1), m_my_from_nod
  */
 Link::~Link()
 {
-    delete m_text_item;
-}
+    ItemRegistry::instance().remove<Link>(m_id, this);
+    TrackGraph::detach(this);
 
-/*
- * Функция Link::updateTextPosition - обновление позиции текста
- * Входные параметры:
- *   отсутствуют
- * Выходные данные:
- *   отсутствуют
- */
-void Link::updateTextPosition()
-{
-    QLineF line = this->line();
-    qreal line_length = line.length();
-    qreal text_width = m_text_item->boundingRect().width();
-    qreal text_x = line.pointAt(0.5).x() - text_width / 2;
-    qreal text_y = line.pointAt(0.5).y() - m_text_item->boundingRect().height() / 2;
-    m_text_item->setPos(text_x, text_y);
-    m_text_item->setOpacity(0);
+    // после remove() узлы остаются в m_my_from_node/m_my_to_node и могут быть
+    // уже удалены: обращаемся только к узлам, в чьем списке связь еще записана
+    if (Node::listsLink(m_my_from_node, this))
+    {
+        m_my_from_node->removeLink(this);
+    }
+    if (Node::listsLink(m_my_to_node, this))
+    {
+        m_my_to_node->removeLink(this);
+    }
+    if (m_trackLayer)
+    {
+        m_trackLayer->removeTrack(this);
+    }
 }
 
 /*
@@ -76,8 +62,10 @@ void Link::updateTextPosition()
  */
 void Link::setGraphId(int graphId)
 {
+    int oldGraphId = m_graphId;
     m_graphId = graphId;
-    m_text_item->setText(QString::number(graphId));
+    TrackGraph::relabel(this, oldGraphId);
+    Editor::instance()->invalidateNetLabel(this);
 }
 
 /*
@@ -89,8 +77,14 @@ void Link::setGraphId(int graphId)
  */
 void Link::setFromNode(Node *node)
 {
+    // концы связи входят в состав ее цепи, поэтому пересчитываем его
+    bool attached = TrackGraph::detach(this);
     m_my_from_node = node;
     m_my_from_node->addLink(this);
+    if (attached)
+    {
+        TrackGraph::attach(this);
+    }
     trackNodes();
 }
 
@@ -103,8 +97,14 @@ void Link::setFromNode(Node *node)
  */
 void Link::setToNode(Node *node)
 {
+    // концы связи входят в состав ее цепи, поэтому пересчитываем его
+    bool attached = TrackGraph::detach(this);
     m_my_to_node = node;
     m_my_to_node->addLink(this);
+    if (attached)
+    {
+        TrackGraph::attach(this);
+    }
     trackNodes();
 }
 
@@ -141,9 +141,20 @@ Node *Link::toNode() const
  */
 void Link::setSide(LinkSide side)
 {
+    LinkSide oldSide = m_side;
     m_side = side;
-    qDebug() << "Link::setSide: " << LinkSideUtils::toString(side);
+    PCB_TRACE(lcScene) << "Link::setSide:" << m_id << LinkSideUtils::toString(side);
     setParentItem(Editor::instance()->m_layers[side]);
+    ItemRegistry::instance().add<Link>(m_id, this);
+    TrackGraph::attach(this);
+    if (m_my_from_node)
+    {
+        m_my_from_node->linkSideChanged(this, oldSide);
+    }
+    if (m_my_to_node)
+    {
+        m_my_to_node->linkSideChanged(this, oldSide);
+    }
     trackNodes();
     refresh();
 }
@@ -159,14 +170,16 @@ void Link::remove()
 {
     if (m_my_from_node)
     {
-        m_my_from_node->removeLinkById(m_id);
+        m_my_from_node->removeLink(this);
     }
     if (m_my_to_node)
     {
-        m_my_to_node->removeLinkById(m_id);
+        m_my_to_node->removeLink(this);
     }
+    Editor::instance()->invalidateNetLabel(this);
     Editor::instance()->getScene()->removeItem(this);
-    Editor::instance()->getScene()->removeItem(m_text_item);
+    ItemRegistry::instance().remove<Link>(m_id, this);
+    TrackGraph::detach(this);
 }
 
 /*
@@ -182,6 +195,7 @@ void Link::setColor(Color color)
     QPen pen(QColor(Config::instance()->color(color)), width);
     pen.setCapStyle(Qt::RoundCap);
     setPen(pen);
+    syncTrack();
 }
 
 /*
@@ -207,9 +221,12 @@ void Link::trackNodes()
 {
     if (m_my_from_node && m_my_to_node)
     {
+        // подпись перерисовывается в старом и новом положении
+        Editor::instance()->invalidateNetLabel(this);
         setLine(QLineF(m_my_from_node->pos(), m_my_to_node->pos()));
         // qDebug() << "trackNodes: from=" << m_my_from_node->pos() << ", to=" << m_my_to_node->pos();
-        updateTextPosition();
+        syncTrack();
+        Editor::instance()->invalidateNetLabel(this);
     }
 }
 
@@ -222,16 +239,8 @@ void Link::trackNodes()
  */
 void Link::refresh()
 {
-    // qDebug() << "Link::refresh, tiene side: " << LinkSideUtils::toString(m_side) << "usa color: " << Config::instance()->color(m_side);
+    // вид узлов на концах обновляется сам при изменении сторон их связей (Node::countLinkSide)
     setColor(ColorUtils::fromLinkSide(m_side));
-    if (m_my_from_node)
-    {
-        m_my_from_node->refresh();
-    }
-    if (m_my_to_node)
-    {
-        m_my_to_node->refresh();
-    }
 }
 
 /*
@@ -272,6 +281,25 @@ void Link::notifyLinkChanges()
     }
 }
 
+/*
+ * Функция Link::forgetNode - сброс ссылки на удаляемый узел
+ * Входные параметры:
+ *   node - удаляемый узел
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Link::forgetNode(const Node *node)
+{
+    if (m_my_from_node == node)
+    {
+        m_my_from_node = nullptr;
+    }
+    if (m_my_to_node == node)
+    {
+        m_my_to_node = nullptr;
+    }
+}
+
 /*
  * Функция Link::genLinkId - генерация ID связи
  * Входные параметры:
@@ -317,7 +345,7 @@ void Link::setLinkCount(int count)
 }
 
 /*
- * Функция Link::updateTextItem - обновление текстового элемента
+ * Функция Link::updateTextItem - обновление подписи цепи
  * Входные параметры:
  *   text - текст
  * Выходные данные:
@@ -325,5 +353,43 @@ void Link::setLinkCount(int count)
  */
 void Link::updateTextItem(const QString &text)
 {
-    qDebug() << "Link::updateTextItem: " << text;
+    PCB_TRACE(lcScene) << "Link::updateTextItem:" << m_id << text;
+    Editor::instance()->invalidateNetLabel(this);
+}
+
+/*
+ * Функция Link::itemChange - перенос трассы при смене слоя или сцены
+ * Входные параметры:
+ *   change - тип изменения
+ *   value - новое значение
+ * Выходные данные:
+ *   QVariant - результат изменения
+ */
+QVariant Link::itemChange(GraphicsItemChange change, const QVariant &value)
+{
+    if (change == QGraphicsItem::ItemParentHasChanged || change == QGraphicsItem::ItemSceneHasChanged)
+    {
+        syncTrack();
+    }
+    return QGraphicsLineItem::itemChange(change, value);
+}
+
+/*
+ * Функция Link::syncTrack - передача трассы слою, который ее рисует
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Link::syncTrack()
+{
+    QGraphicsItemLayer *layer = scene() ? item_cast<QGraphicsItemLayer>(parentItem()) : nullptr;
+    if (layer && m_my_from_node && m_my_to_node)
+    {
+        layer->setTrack(this, line().translated(pos()), pen());
+    }
+    else if (m_trackLayer)
+    {
+        m_trackLayer->removeTrack(this);
+    }
 }
@@ -2,45 +2,17 @@
 #define LINK_H
 
 #include <QGraphicsLineItem>
-#include <QGraphicsSimpleTextItem>
 #include <QPen>
 #include <QColor>
 #include <QFont>
 #include "Config.h"
 #include "enums.h"
+#include "TrackGraph.h"
+#include "Adjacency.h"
+#include "TypeChecks.h"
 
 class Node;
-
-/*
- * Класс TrackGraph - граф трассировки
- *
- * Основные функции:
- * 1. genTrackGraphId() - генерация ID графа трассировки
- * 2. setTrackGraphCount(int count) - установка счетчика графов трассировки
- */
-class TrackGraph
-{
-public:
-    static int count;
-
-    static int genTrackGraphId()
-    {
-        count++;
-        return count;
-    }
-
-    static void setTrackGraphCount(int count)
-    {
-        if (count >= 0)
-        {
-            TrackGraph::count = count;
-        }
-        else
-        {
-            throw std::invalid_argument("count must be a non-negative integer");
-        }
-    }
-};
+class QGraphicsItemLayer;
 
 /*
  * Класс Link - связь между узлами
@@ -64,8 +36,15 @@ public:
  * 16. genLinkId() - генерация ID связи
  * 17. getLastLinkId() - получение последнего ID связи
  * 18. setLinkCount(int count) - установка счетчика связей
- * 19. updateTextItem(const QString& text) - обновление текстового элемента
- * 20. updateTextPosition() - обновление позиции текста
+ * 19. updateTextItem(const QString& text) - обновление подписи цепи
+ * 20. itemChange(...) - перенос трассы при смене слоя или сцены
+ * 21. forgetNode(const Node* node) - сброс ссылки на удаляемый узел
+ * 22. type() const - тип элемента сцены для item_cast
+ *
+ * Трассу связи рисует ее слой (QGraphicsItemLayer), сама связь не рисуется.
+ *
+ * Подпись с номером цепи не является элементом сцены: ее рисует Editor
+ * в режиме подписей цепей (см. Editor::setNetLabelsVisible).
  */
 class Link : public QGraphicsLineItem
 {
@@ -75,6 +54,9 @@ public:
     Link(int id);
     ~Link();
 
+    enum { Type = LinkItem, LastType = Type };
+    int type() const override { return Type; }
+
     void setGraphId(int graph_id);
     void setFromNode(Node *node);
     void setToNode(Node *node);
@@ -88,6 +70,7 @@ public:
     void refresh();
     void setHighlighted(bool is_highlighted);
     void notifyLinkChanges();
+    void forgetNode(const Node *node);
 
     static int genLinkId();
     static int getLastLinkId();
@@ -95,17 +78,31 @@ public:
 
     void updateTextItem(const QString &text);
 
+    // позиции связи в списках связей ее узлов (см. AdjacencyList)
+    AdjacencySlots<2> &adjacencySlots() const { return m_adjacencySlots; }
+
     LinkSide m_side;
     int m_id;
     int m_graphId;
     std::optional<int> m_width;
 
+protected:
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
+
 private:
-    void updateTextPosition();
+    friend class QGraphicsItemLayer;
+
+    void syncTrack();
 
     Node *m_my_from_node;
     Node *m_my_to_node;
-    QGraphicsSimpleTextItem *m_text_item;
+    mutable AdjacencySlots<2> m_adjacencySlots;
+
+    // положение трассы в слое, который ее рисует
+    QGraphicsItemLayer *m_trackLayer = nullptr;
+    int m_trackBatch = -1;
+    quint64 m_trackCell = 0;
+    int m_trackIndex = -1;
 };
 
 #endif // LINK_H
\ No newline at end of file
@@ -7,10 +7,18 @@
 #include <QIcon>
 #include <QApplication>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QtConcurrent>
+#include <QProgressDialog>
+#include <QEventLoop>
+#include <QScopeGuard>
 #include "Config.h"
 #include "ColorBox.h"
 #include "SceneLoader.h"
 #include "SceneLoaderBinary.h"
+#include "SceneSnapshot.h"
+#include "Trace.h"
+#include "ImagePyramid.h"
 #include "ConfigDialog.h"
 #include "ConnectionAnalyzer.h"
 
@@ -145,6 +153,12 @@ MainWindow::MainWindow(QWidget *parent)
 
     QAction *toggleAction = m_sidebar->toggleViewAction();
     viewMenu->addAction(toggleAction);
+
+    // Net labels are drawn by the editor only while this mode is on
+    QAction *netLabelsAction = new QAction("Show Net Labels", this);
+    netLabelsAction->setCheckable(true);
+    connect(netLabelsAction, &QAction::toggled, m_editor, &Editor::setNetLabelsVisible);
+    viewMenu->addAction(netLabelsAction);
     viewMenu->addSeparator();
     // Add the About action to the View menu
     QAction *aboutAction = new QAction("About", this);
@@ -156,6 +170,15 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_autoSaveTimer, &QTimer::timeout, this, &MainWindow::autoSaveProject);
     m_autoSaveTimer->start(5 * 60 * 1000); // 5 minutes in milliseconds
 
+    // Result of the background autosave is handled on the GUI thread
+    connect(&m_autoSaveWatcher, &QFutureWatcher<bool>::finished, this, [this]()
+            {
+        if (!m_autoSaveWatcher.result())
+        {
+            m_changesSinceLastAutosave = true; // retry on the next timer tick
+            m_editor->showStatusMessage("Autosave failed.");
+        } });
+
     connect(&(m_editor->m_undoStack), &QUndoStack::indexChanged, this, [this]()
             {
         m_changesSinceLastAutosave = true; // Mark changes when the undo stack index changes
@@ -172,6 +195,7 @@ MainWindow::MainWindow(QWidget *parent)
 MainWindow::~MainWindow()
 {
     qDebug() << "MainWindow::~MainWindow()";
+    m_autoSaveWatcher.waitForFinished();
     delete m_editor;
     delete m_sidebar;
     delete m_colorBox;
@@ -427,41 +451,94 @@ void MainWindow::loadProject()
  */
 void MainWindow::loadProjectFromFile(const QString &filePath, bool isAutoLoad)
 {
-    bool success = false;
+    bool isJson = filePath.endsWith(".jpcb", Qt::CaseInsensitive);
+    if (!isJson && !filePath.endsWith(".pcb", Qt::CaseInsensitive))
+    {
+        QMessageBox::warning(this, "Unsupported File", "The selected file format is not supported.");
+        return;
+    }
     Editor::instance()->clean();
-    if (filePath.endsWith(".jpcb", Qt::CaseInsensitive))
+
+    // The event loop keeps running while loading, so autosave must not snapshot a half-built scene
+    m_autoSaveTimer->stop();
+    auto restartAutosave = qScopeGuard([this]()
+                                       { m_autoSaveTimer->start(); });
+
+    // The dialog is shown right away: it is what blocks input to the window while the
+    // nested event loop runs, otherwise one could draw, start another load or close the window
+    QProgressDialog progress("Reading project...", "Cancel", 0, 100, this);
+    progress.setWindowModality(Qt::WindowModal);
+    progress.setMinimumDuration(0);
+    progress.open();
+
+    // The file is decoded into plain structs on a worker thread, the GUI thread only shows progress
+    QElapsedTimer timer;
+    timer.start();
+    SceneSnapshot snapshot;
+    QString error;
+    QFutureWatcher<bool> decodeWatcher;
+    QEventLoop decodeLoop;
+    connect(&decodeWatcher, &QFutureWatcher<bool>::progressValueChanged, &progress, &QProgressDialog::setValue);
+    connect(&decodeWatcher, &QFutureWatcher<bool>::finished, &decodeLoop, &QEventLoop::quit);
+    connect(&progress, &QProgressDialog::canceled, &decodeWatcher, &QFutureWatcher<bool>::cancel);
+    decodeWatcher.setFuture(QtConcurrent::run([filePath, isJson, &snapshot, &error](QPromise<bool> &promise)
+                                              {
+        auto report = [&promise](int percent)
+        {
+            promise.setProgressValue(percent);
+            return !promise.isCanceled();
+        };
+        promise.addResult(isJson ? SceneLoader::decodeJson(filePath, snapshot, error, report)
+                                 : SceneLoaderBinary::decodeBinary(filePath, snapshot, error, report)); }));
+    if (!decodeWatcher.isFinished())
     {
-        success = SceneLoader::loadSceneFromJson(filePath);
+        decodeLoop.exec();
     }
-    else if (filePath.endsWith(".pcb", Qt::CaseInsensitive))
+    qint64 decodeTime = timer.restart();
+
+    // An autosave file "~name" belongs to the project "name"
+    QString projectPath = filePath;
+    if (isAutoLoad)
     {
-        success = SceneLoaderBinary::loadSceneFromBinary(filePath);
+        QFileInfo fileInfo(filePath);
+        projectPath = fileInfo.dir().absoluteFilePath(fileInfo.fileName().mid(1));
     }
-    else
+
+    bool success = !decodeWatcher.isCanceled() && decodeWatcher.result();
+    if (success)
     {
-        QMessageBox::warning(this, "Unsupported File", "The selected file format is not supported.");
+        // Image tile caches of the loaded layers go next to the loaded project
+        ImagePyramid::setProjectPath(projectPath);
+
+        // Items are created in bulk on the GUI thread
+        progress.setLabelText("Building scene...");
+        progress.setValue(0);
+        success = snapshot.restore([&progress](int percent)
+                                   {
+            progress.setValue(percent);
+            return !progress.wasCanceled(); });
+    }
+    qCDebug(lcLoad) << "Project decoded in" << decodeTime << "ms, scene built in" << timer.elapsed() << "ms";
+
+    if (progress.wasCanceled())
+    {
+        ImagePyramid::setProjectPath(m_currentFilePath);
+        Editor::instance()->clean();
+        m_editor->showStatusMessage("Loading cancelled.");
         return;
     }
+    progress.reset();
 
     if (success)
     {
-        if (!isAutoLoad)
-        {
-            setCurrentFilePath(filePath);
-        }
-        else
-        {
-            // set the currentFilePath to the autosave file path without the~suffix
-            QFileInfo fileInfo(filePath);
-            QString originalFilePath = fileInfo.dir().absoluteFilePath(fileInfo.fileName().mid(1));
-            setCurrentFilePath(originalFilePath);
-        }
+        setCurrentFilePath(projectPath);
         m_editor->showStatusMessage("Project loaded successfully.");
         // QMessageBox::information(this, "Load Successful", "The project was loaded successfully.");
     }
     else
     {
-        QMessageBox::critical(this, "Load Failed", "Failed to load the project. Please check the file and try again.");
+        ImagePyramid::setProjectPath(m_currentFilePath);
+        QMessageBox::critical(this, "Load Failed", QString("Failed to load the project. Please check the file and try again.\n%1").arg(error));
     }
 }
 
@@ -695,6 +772,7 @@ void MainWindow::openConfigDialog()
 void MainWindow::setCurrentFilePath(const QString &filePath)
 {
     m_currentFilePath = filePath;
+    ImagePyramid::setProjectPath(filePath);
     if (m_currentFilePath.isEmpty())
     {
         setWindowTitle(m_windowBaseTitle);
@@ -820,6 +898,7 @@ QString MainWindow::getAutosaveFilePath(QString filePath)
  */
 void MainWindow::removeAutosaveFile()
 {
+    m_autoSaveWatcher.waitForFinished(); // a running autosave would recreate the file
     QString tempFilePath = getAutosaveFilePath(m_currentFilePath);
     // check if it exists before trying to delete it
     if (QFile::exists(tempFilePath))
@@ -837,6 +916,7 @@ void MainWindow::removeAutosaveFile()
  */
 void MainWindow::renameToAutosaveFile(QString filePath)
 {
+    m_autoSaveWatcher.waitForFinished();
     QString tempFilePath = getAutosaveFilePath(m_currentFilePath);
     // check if it exists before trying to delete it
     if (QFile::exists(filePath))
@@ -859,9 +939,31 @@ void MainWindow::autoSaveProject()
         qDebug() << "No changes to autosave.";
         return; // don't autosave if there are no changes
     }
+    if (m_autoSaveWatcher.isRunning())
+    {
+        qDebug() << "Previous autosave is still running.";
+        return; // try again on the next timer tick
+    }
     QString tempFilePath = getAutosaveFilePath(m_currentFilePath);
     m_changesSinceLastAutosave = false; // reset the changes flag
-    saveToFile(tempFilePath, true);     // save to file as autosave
+
+    // Only the snapshot is taken on the GUI thread, serialization and disk I/O run on a worker
+    QElapsedTimer timer;
+    timer.start();
+    SceneSnapshot snapshot = SceneSnapshot::capture();
+    qCDebug(lcLoad) << "Autosave snapshot taken in" << timer.nsecsElapsed() / 1000000.0 << "ms,"
+                    << snapshot.links.size() << "links";
+
+    if (tempFilePath.endsWith(".jpcb", Qt::CaseInsensitive))
+    {
+        m_autoSaveWatcher.setFuture(QtConcurrent::run([snapshot = std::move(snapshot), tempFilePath]()
+                                                      { return SceneLoader::saveSnapshotToJson(snapshot, tempFilePath); }));
+    }
+    else
+    {
+        m_autoSaveWatcher.setFuture(QtConcurrent::run([snapshot = std::move(snapshot), tempFilePath]()
+                                                      { return SceneLoaderBinary::saveSnapshotToBinary(snapshot, tempFilePath); }));
+    }
 }
 
 /*
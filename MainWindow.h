@@ -7,6 +7,7 @@
 #include <QAction>
 #include <QActionGroup>
 #include <QUndoStack>
+#include <QFutureWatcher>
 #include "Editor.h"
 #include "ColorBox.h"
 #include "Sidebar.h"
@@ -103,6 +104,7 @@ private:
     ColorBox *m_colorBox;
     Sidebar *m_sidebar;
     QTimer *m_autoSaveTimer;
+    QFutureWatcher<bool> m_autoSaveWatcher;
     bool m_changesSinceLastAutosave;
     bool m_wasJustAutosaved;
 
@@ -0,0 +1,205 @@
+#include "Netlist.h"
+#include "SceneSnapshot.h"
+#include <QStringList>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+/*
+ * Функция Netlist::Netlist - список из готовых цепей
+ * Входные параметры:
+ *   nets - цепи с контактами без повторов
+ */
+Netlist::Netlist(std::vector<NetlistNet> nets)
+    : m_nets(std::move(nets))
+{
+    sortNets();
+}
+
+/*
+ * Функция Netlist::fromSnapshot - список соединений по снимку сцены
+ * Входные параметры:
+ *   snapshot - снимок сцены
+ * Выходные данные:
+ *   Netlist - цепи снимка, к которым подключены контакты
+ */
+Netlist Netlist::fromSnapshot(const SceneSnapshot &snapshot)
+{
+    // Контакты по ID; при повторяющихся ID остается первый, как при восстановлении сцены
+    std::unordered_map<int, NetlistPad> padsById;
+    for (const ComponentRecord &component : snapshot.components)
+    {
+        for (const PadRecord &pad : component.pads)
+        {
+            padsById.emplace(pad.id, NetlistPad{pad.id, component.id, component.name, pad.name, pad.number});
+        }
+    }
+
+    // Один проход по связям: концы-контакты собираются в хеш-множество своей цепи
+    struct NetPads
+    {
+        std::unordered_set<int> seen;
+        std::vector<const NetlistPad *> pads;
+    };
+    std::unordered_map<int, NetPads> nets;
+    for (const LinkRecord &link : snapshot.links)
+    {
+        for (int nodeId : {link.fromNodeId, link.toNodeId})
+        {
+            auto pad = padsById.find(nodeId);
+            if (pad == padsById.end())
+            {
+                continue;
+            }
+            NetPads &net = nets[link.graphId];
+            if (net.seen.insert(nodeId).second)
+            {
+                net.pads.push_back(&pad->second);
+            }
+        }
+    }
+
+    std::vector<NetlistNet> entries;
+    entries.reserve(nets.size());
+    for (const auto &[graphId, net] : nets)
+    {
+        NetlistNet entry{graphId, {}};
+        entry.pads.reserve(net.pads.size());
+        for (const NetlistPad *pad : net.pads)
+        {
+            entry.pads.push_back(*pad);
+        }
+        entries.push_back(std::move(entry));
+    }
+    return Netlist(std::move(entries));
+}
+
+/*
+ * Функция Netlist::padCount - общее число контактов во всех цепях
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   size_t - число контактов
+ */
+size_t Netlist::padCount() const
+{
+    size_t count = 0;
+    for (const NetlistNet &net : m_nets)
+    {
+        count += net.pads.size();
+    }
+    return count;
+}
+
+/*
+ * Функция Netlist::toText - текстовое представление списка соединений
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   QString - одна строка на цепь, имена контактов через " | "
+ */
+QString Netlist::toText() const
+{
+    QString text;
+    for (const NetlistNet &net : m_nets)
+    {
+        QStringList padNames;
+        padNames.reserve(net.pads.size());
+        for (const NetlistPad &pad : net.pads)
+        {
+            padNames << pad.name;
+        }
+        text += padNames.join(" | ") + "\n";
+    }
+    return text;
+}
+
+/*
+ * Функция Netlist::toCsv - список соединений в формате CSV
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   QString - заголовок и по строке на каждый контакт каждой цепи
+ */
+QString Netlist::toCsv() const
+{
+    // Поля с запятыми или кавычками заключаются в кавычки
+    auto quoted = [](const QString &field) -> QString
+    {
+        if (!field.contains(',') && !field.contains('"') && !field.contains('\n'))
+        {
+            return field;
+        }
+        QString escaped = field;
+        escaped.replace("\"", "\"\"");
+        return "\"" + escaped + "\"";
+    };
+
+    QString csv = "net,component,pad,number,pad_id\n";
+    for (const NetlistNet &net : m_nets)
+    {
+        for (const NetlistPad &pad : net.pads)
+        {
+            csv += QString("%1,%2,%3,%4,%5\n")
+                       .arg(net.graphId)
+                       .arg(quoted(pad.component), quoted(pad.name))
+                       .arg(pad.number)
+                       .arg(pad.id);
+        }
+    }
+    return csv;
+}
+
+/*
+ * Функция Netlist::toJson - список соединений в формате JSON
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   QByteArray - [{"net": id, "pads": [{"id", "component", "name", "number"}]}]
+ */
+QByteArray Netlist::toJson() const
+{
+    QJsonArray nets;
+    for (const NetlistNet &net : m_nets)
+    {
+        QJsonArray pads;
+        for (const NetlistPad &pad : net.pads)
+        {
+            pads.append(QJsonObject{
+                {"id", pad.id},
+                {"component", pad.component},
+                {"name", pad.name},
+                {"number", pad.number}});
+        }
+        nets.append(QJsonObject{{"net", net.graphId}, {"pads", pads}});
+    }
+    return QJsonDocument(nets).toJson(QJsonDocument::Compact);
+}
+
+/*
+ * Функция Netlist::sortNets - упорядочивание цепей по ID графа,
+ * а контактов цепи - по компоненту и номеру
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   отсутствуют
+ */
+void Netlist::sortNets()
+{
+    std::sort(m_nets.begin(), m_nets.end(), [](const NetlistNet &a, const NetlistNet &b)
+              { return a.graphId < b.graphId; });
+    for (NetlistNet &net : m_nets)
+    {
+        std::sort(net.pads.begin(), net.pads.end(), [](const NetlistPad &a, const NetlistPad &b)
+                  {
+                      if (a.componentId != b.componentId)
+                          return a.componentId < b.componentId;
+                      if (a.number != b.number)
+                          return a.number < b.number;
+                      return a.id < b.id;
+                  });
+    }
+}
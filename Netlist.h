@@ -0,0 +1,100 @@
+#ifndef NETLIST_H
+#define NETLIST_H
+
+#include <QString>
+#include <QByteArray>
+#include <vector>
+
+struct SceneSnapshot;
+
+/**
+ * @brief Контакт в составе цепи
+ */
+struct NetlistPad
+{
+    int id;            ///< Идентификатор контакта
+    int componentId;   ///< Идентификатор компонента (-1 - без компонента)
+    QString component; ///< Имя компонента
+    QString name;      ///< Имя контакта (включает имя компонента)
+    int number;        ///< Номер контакта в компоненте
+};
+
+/**
+ * @brief Цепь списка соединений
+ */
+struct NetlistNet
+{
+    int graphId;                  ///< Идентификатор графа (цепи)
+    std::vector<NetlistPad> pads; ///< Контакты цепи без повторов, по компоненту и номеру
+};
+
+/**
+ * @brief Список соединений платы: для каждой цепи - множество ее контактов
+ *
+ * Строится за один линейный проход по связям снимка сцены (SceneSnapshot): контакты цепи
+ * собираются в хеш-множество, поэтому повторные концы связей на одном контакте
+ * не дают квадратичной проверки.
+ * Не ссылается на графические элементы и может передаваться между потоками,
+ * в экспорт и в модель таблицы (NetlistModel). Список текущей сцены строит
+ * ConnectionAnalyzer::netlist().
+ *
+ * В список попадают только цепи, к которым подключен хотя бы один контакт.
+ * Цепи упорядочены по ID графа.
+ */
+class Netlist
+{
+public:
+    Netlist() = default;
+
+    /**
+     * @brief Создает список из готовых цепей
+     * @param nets Цепи с контактами без повторов; упорядочиваются конструктором
+     */
+    explicit Netlist(std::vector<NetlistNet> nets);
+
+    /**
+     * @brief Строит список соединений по снимку сцены
+     *
+     * Не обращается к графическим элементам, поэтому может вызываться из рабочего потока.
+     * @param snapshot Снимок сцены
+     * @return Список соединений
+     */
+    static Netlist fromSnapshot(const SceneSnapshot &snapshot);
+
+    /**
+     * @brief Возвращает цепи списка
+     * @return Цепи, упорядоченные по ID графа
+     */
+    const std::vector<NetlistNet> &nets() const { return m_nets; }
+
+    /**
+     * @brief Возвращает общее число контактов во всех цепях
+     * @return Число контактов
+     */
+    size_t padCount() const;
+
+    /**
+     * @brief Преобразует список в текст: одна строка на цепь, контакты через " | "
+     * @return Текстовое представление списка
+     */
+    QString toText() const;
+
+    /**
+     * @brief Преобразует список в CSV: строка на контакт (net,component,pad,number,pad_id)
+     * @return Текст CSV с заголовком
+     */
+    QString toCsv() const;
+
+    /**
+     * @brief Преобразует список в JSON: массив цепей с их контактами
+     * @return Документ JSON в компактной записи
+     */
+    QByteArray toJson() const;
+
+private:
+    void sortNets();
+
+    std::vector<NetlistNet> m_nets; ///< Цепи списка соединений
+};
+
+#endif // NETLIST_H
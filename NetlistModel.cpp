@@ -0,0 +1,104 @@
+#include "NetlistModel.h"
+#include <QStringList>
+
+/*
+ * Функция NetlistModel::NetlistModel - конструктор модели
+ * Входные параметры:
+ *   netlist - список соединений
+ *   parent - родительский объект
+ */
+NetlistModel::NetlistModel(Netlist netlist, QObject *parent)
+    : QAbstractTableModel(parent), m_netlist(std::move(netlist))
+{
+}
+
+/*
+ * Функция NetlistModel::setNetlist - замена списка соединений
+ * Входные параметры:
+ *   netlist - новый список соединений
+ * Выходные данные:
+ *   отсутствуют
+ */
+void NetlistModel::setNetlist(Netlist netlist)
+{
+    beginResetModel();
+    m_netlist = std::move(netlist);
+    endResetModel();
+}
+
+int NetlistModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_netlist.nets().size());
+}
+
+int NetlistModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+/*
+ * Функция NetlistModel::data - данные ячейки
+ * Входные параметры:
+ *   index - индекс ячейки
+ *   role - роль данных
+ * Выходные данные:
+ *   QVariant - ID цепи, число контактов или имена контактов через " | "
+ */
+QVariant NetlistModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+    {
+        return {};
+    }
+
+    const NetlistNet &net = m_netlist.nets()[index.row()];
+    if (role == Qt::TextAlignmentRole && index.column() != PadsColumn)
+    {
+        return int(Qt::AlignRight | Qt::AlignVCenter);
+    }
+    if (role != Qt::DisplayRole && role != Qt::ToolTipRole)
+    {
+        return {};
+    }
+
+    switch (index.column())
+    {
+    case NetColumn:
+        return net.graphId;
+    case PadCountColumn:
+        return static_cast<int>(net.pads.size());
+    case PadsColumn:
+    {
+        // строка собирается только для видимых ячеек
+        QStringList padNames;
+        padNames.reserve(net.pads.size());
+        for (const NetlistPad &pad : net.pads)
+        {
+            padNames << pad.name;
+        }
+        return padNames.join(role == Qt::ToolTipRole ? "\n" : " | ");
+    }
+    default:
+        return {};
+    }
+}
+
+QVariant NetlistModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+    {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+
+    switch (section)
+    {
+    case NetColumn:
+        return QStringLiteral("Net");
+    case PadCountColumn:
+        return QStringLiteral("Pads");
+    case PadsColumn:
+        return QStringLiteral("Connections");
+    default:
+        return {};
+    }
+}
@@ -0,0 +1,59 @@
+#ifndef NETLISTMODEL_H
+#define NETLISTMODEL_H
+
+#include <QAbstractTableModel>
+#include "Netlist.h"
+
+/**
+ * @brief Модель таблицы списка соединений
+ *
+ * Одна строка на цепь: ID цепи, число контактов и имена контактов.
+ * Текст строки собирается только при запросе данных, поэтому представление
+ * (QTableView) обращается лишь к видимым строкам и остается отзывчивым
+ * на десятках тысяч цепей.
+ */
+class NetlistModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Столбцы таблицы
+     */
+    enum Column
+    {
+        NetColumn,      ///< ID цепи
+        PadCountColumn, ///< Число контактов
+        PadsColumn,     ///< Имена контактов
+        ColumnCount
+    };
+
+    /**
+     * @brief Конструктор модели
+     * @param netlist Список соединений
+     * @param parent Родительский объект
+     */
+    explicit NetlistModel(Netlist netlist, QObject *parent = nullptr);
+
+    /**
+     * @brief Заменяет список соединений модели
+     * @param netlist Новый список соединений
+     */
+    void setNetlist(Netlist netlist);
+
+    /**
+     * @brief Возвращает список соединений модели
+     * @return Список соединений
+     */
+    const Netlist &netlist() const { return m_netlist; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    Netlist m_netlist; ///< Отображаемый список соединений
+};
+
+#endif // NETLISTMODEL_H
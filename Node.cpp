@@ -3,10 +3,14 @@
 #include "Editor.h"
 #include "Component.h"
 #include "actions/MoveNode.h"
+#include "ItemRegistry.h"
+#include "RenderLod.h"
+#include "NodeIndex.h"
 
 int Node::node_count = 0;
+bool Node::s_refreshDeferred = false;
 
-Node::Node(int id) : QGraphicsEllipseItem(), m_id(id), m_size(0), m_side(LinkSide::FRONT), m_links()
+Node::Node(int id) : QGraphicsEllipseItem(), m_id(id), m_size(0), m_side(LinkSide::FRONT)
 {
     Editor *editor = Editor::instance();
     m_size = 20; // editor->padSize();
@@ -24,12 +28,30 @@ Node::Node(int id) : QGraphicsEllipseItem(), m_id(id), m_size(0), m_side(LinkSid
         setOpacity(0.001);
     }
     setAcceptHoverEvents(true);
+
+    ItemRegistry::instance().add<Node>(m_id, this);
+}
+
+Node::~Node()
+{
+    if (m_hovered)
+    {
+        Editor::instance()->hideNodeHover(this);
+    }
+    NodeIndex::remove(this);
+    ItemRegistry::instance().remove<Node>(m_id, this);
+
+    // Связи переживают узел и не должны обращаться к нему
+    for (Link *link : m_links)
+    {
+        link->forgetNode(this);
+    }
 }
 
 void Node::notifyLinkChanges()
 {
     // Проверяем, что это не Pad (так как Pad имеет собственную логику)
-    if (typeid(*this).name() != typeid(Pad).name())
+    if (type() != Pad::Type)
     {
         // Публикуем событие в зависимости от количества связей
         if (m_links.size() > 1)
@@ -57,34 +79,28 @@ void Node::addLink(Link *link)
         return;
     }
 
-    // Проверяем, что такая связь еще не добавлена
-    if (std::find(m_links.begin(), m_links.end(), link) == m_links.end())
+    // Связь, уже подключенная к узлу, не добавляется повторно
+    if (m_links.add(link))
     {
-        try
-        {
-            m_links.push_back(link);
-        }
-        catch (const std::exception &e)
-        {
-            qDebug() << "Exception caught while adding link:" << e.what();
-        }
-        catch (...)
-        {
-            qDebug() << "Unknown exception caught while adding link";
-        }
+        countLinkSide(link->m_side, 1);
     }
 }
 
 void Node::removeLink(Link *link)
 {
-    // Ищем связь в векторе и удаляем её
-    auto it = std::find(m_links.begin(), m_links.end(), link);
-    if (it != m_links.end())
+    // Удаляем связь за O(1), связь хранит свою позицию в списке
+    if (m_links.remove(link))
     {
-        m_links.erase(it);
+        countLinkSide(link->m_side, -1);
     }
 }
 
+bool Node::listsLink(const Node *node, const Link *link)
+{
+    // Адрес списка берется без чтения узла: узел может быть уже удален
+    return node && link->adjacencySlots().find(&node->m_links) != nullptr;
+}
+
 void Node::removeLinkById(int link_id)
 {
     // Ищем связь по ID и удаляем её
@@ -93,7 +109,7 @@ void Node::removeLinkById(int link_id)
                            { return link->m_id == link_id; });
     if (it != m_links.end())
     {
-        m_links.erase(it);
+        removeLink(*it);
     }
 }
 
@@ -118,8 +134,8 @@ int Node::getGrade() const
 
 std::vector<Link *> Node::getLinks() const
 {
-    // Возвращаем копию вектора связей
-    return m_links;
+    // Возвращаем копию списка связей
+    return std::vector<Link *>(m_links.begin(), m_links.end());
 }
 
 void Node::updateLinks()
@@ -133,16 +149,47 @@ void Node::updateLinks()
 
 bool Node::shouldReactToHover() const
 {
-    Editor *editor = Editor::instance();
     // Проверяем, есть ли связи на текущей стороне платы или в процессе работы
-    for (const Link *link : m_links)
+    quint8 sides = sideBit(Editor::instance()->m_currentSide) | sideBit(LinkSide::WIP);
+    return (m_sideMask & sides) != 0;
+}
+
+void Node::linkSideChanged(const Link *link, LinkSide oldSide)
+{
+    if (link->m_side == oldSide || !m_links.contains(link))
     {
-        if (link->m_side == editor->m_currentSide || link->m_side == LinkSide::WIP)
-        {
-            return true;
-        }
+        return;
+    }
+    countLinkSide(oldSide, -1);
+    countLinkSide(link->m_side, 1);
+}
+
+void Node::countLinkSide(LinkSide side, int delta)
+{
+    // Счетчики и маска меняются только при изменении связей, а не при каждом наведении или обновлении
+    bool wasMixed = (m_sideMask & (m_sideMask - 1)) != 0;
+
+    int &count = m_sideCounts[static_cast<int>(side)];
+    count += delta;
+    if (count > 0)
+    {
+        m_sideMask |= sideBit(side);
+    }
+    else
+    {
+        m_sideMask &= quint8(~sideBit(side));
     }
-    return false;
+
+    bool isMixed = (m_sideMask & (m_sideMask - 1)) != 0;
+    if (isMixed != wasMixed && !s_refreshDeferred)
+    {
+        refresh();
+    }
+}
+
+void Node::setRefreshDeferred(bool deferred)
+{
+    s_refreshDeferred = deferred;
 }
 
 QVariant Node::itemChange(GraphicsItemChange change, const QVariant &value)
@@ -155,6 +202,24 @@ QVariant Node::itemChange(GraphicsItemChange change, const QVariant &value)
             link->trackNodes();
         }
     }
+
+    // Пространственный индекс следит за положением узлов на сцене
+    if (change == QGraphicsItem::ItemPositionHasChanged || change == QGraphicsItem::ItemSceneHasChanged ||
+        change == QGraphicsItem::ItemParentHasChanged)
+    {
+        NodeIndex::update(this);
+        if (m_hovered && change == QGraphicsItem::ItemPositionHasChanged)
+        {
+            Editor::instance()->showNodeHover(this);
+        }
+    }
+
+    // Узел, убранный со сцены (например, отменой рисования), не получит hoverLeave
+    if (change == QGraphicsItem::ItemSceneHasChanged && m_hovered && value.value<QGraphicsScene *>() == nullptr)
+    {
+        m_hovered = false;
+        Editor::instance()->hideNodeHover(this);
+    }
     return QGraphicsEllipseItem::itemChange(change, value);
 }
 
@@ -166,52 +231,42 @@ void Node::enable()
 
 void Node::disable()
 {
-    // Отключаем возможность перемещения узла
-    setFlags(QGraphicsItem::GraphicsItemFlags(0));
+    // Отключаем возможность перемещения узла (уведомления о перемещении нужны индексу узлов)
+    setFlags(QGraphicsItem::ItemSendsGeometryChanges);
 }
 
 void Node::hoverEnterEvent(QGraphicsSceneHoverEvent *event)
 {
     // Для обычных узлов проверяем, должны ли они реагировать на наведение
-    if (typeid(*this).name() == typeid(Node).name())
+    if (type() == Node::Type)
     {
-        if (shouldReactToHover())
+        bool react = shouldReactToHover();
+        if (bool(flags() & QGraphicsItem::ItemIsMovable) != react)
         {
-            enable();
+            react ? enable() : disable();
         }
-        else
+        if (!react)
         {
-            disable();
             return;
         }
     }
 
-    // При наведении показываем узел и отображаем сообщение в статусной строке
+    // Скрытый узел показывается общей подсветкой редактора, сам узел не перерисовывается
     if (m_showOnHover)
     {
-        setOpacity(1);
+        m_hovered = true;
+        Editor::instance()->showNodeHover(this);
         Editor::instance()->showStatusMessage(QString("Node %1").arg(m_id));
     }
-
-    // Для контактных площадок отображаем имя
-    if (Pad *pad = dynamic_cast<Pad *>(this))
-    {
-        Editor::instance()->showStatusMessage(pad->m_name);
-    }
 }
 
 void Node::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
 {
-    // При уходе мыши скрываем узел (если это нужно) и очищаем статусную строку
-    if (m_showOnHover)
-    {
-        setOpacity(0.001);
-        Editor::instance()->showStatusMessage("");
-    }
-
-    // Для контактных площадок также очищаем статусную строку
-    if (typeid(*this).name() == typeid(Pad).name())
+    // При уходе мыши убираем подсветку и очищаем статусную строку
+    if (m_hovered)
     {
+        m_hovered = false;
+        Editor::instance()->hideNodeHover(this);
         Editor::instance()->showStatusMessage("");
     }
 
@@ -226,37 +281,40 @@ QPainterPath Node::shape() const
     return path;
 }
 
+void Node::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    // Узлы, скрытые до наведения, все равно невидимы (прозрачность 0.01 и меньше)
+    if (m_showOnHover && opacity() <= 0.01)
+    {
+        return;
+    }
+
+    // При сильном уменьшении узел меньше пары пикселей и не различим
+    if (rect().width() * RenderLod::levelOfDetail(painter) < RenderLod::NodeMinPixels)
+    {
+        return;
+    }
+
+    QGraphicsEllipseItem::paint(painter, option, widget);
+}
+
 void Node::setSide(LinkSide side)
 {
     // Устанавливаем сторону платы и перемещаем узел в соответствующий слой
     m_side = side;
     setParentItem(Editor::instance()->m_layers[side]);
+    ItemRegistry::instance().add<Node>(m_id, this);
 }
 
 void Node::refresh()
 {
-    std::vector<LinkSide> sides;
-
-    // Получаем список сторон, к которым подключены связи
-    for (const Link *link : m_links)
-    {
-        sides.push_back(link->m_side);
-    }
-
     // Для обычных узлов: если они соединяют несколько сторон,
     // отключаем эффект наведения и показываем всегда
-    if (typeid(*this) == typeid(Node))
+    if (type() == Node::Type)
     {
-        if (std::adjacent_find(sides.begin(), sides.end(), std::not_equal_to<>()) != sides.end())
-        {
-            m_showOnHover = false;
-            setOpacity(1);
-        }
-        else
-        {
-            m_showOnHover = true;
-            setOpacity(0.01);
-        }
+        bool isMixed = (m_sideMask & (m_sideMask - 1)) != 0;
+        m_showOnHover = !isMixed;
+        setOpacity(isMixed ? 1 : 0.01);
     }
 }
 
@@ -5,9 +5,12 @@
 #include <QPen>
 #include <QBrush>
 #include <vector>
+#include <array>
 #include "Config.h"
 #include "enums.h"
 #include "CommunicationHub.h"
+#include "Adjacency.h"
+#include "TypeChecks.h"
 
 class Link;
 
@@ -23,12 +26,28 @@ public:
     static int node_count; ///< Статический счетчик узлов для генерации уникальных ID
     bool m_showOnHover;    ///< Флаг, определяющий отображение узла при наведении мыши
 
+    /// Тип элемента для item_cast; диапазон включает наследников Pad и PhantomPad
+    enum { Type = NodeItem, LastType = PhantomPadItem };
+
+    /**
+     * @brief Возвращает тип элемента сцены
+     * @return Node::Type
+     */
+    int type() const override { return Type; }
+
     /**
      * @brief Конструктор узла
      * @param id Уникальный идентификатор узла
      */
     Node(int id);
 
+    /**
+     * @brief Деструктор узла
+     *
+     * Удаляет узел из реестра элементов
+     */
+    ~Node();
+
     /**
      * @brief Уведомляет о изменениях в связях узла
      *
@@ -57,6 +76,8 @@ public:
 
     /**
      * @brief Удаляет связь по идентификатору
+     *
+     * Просматривает все связи узла; если связь известна, быстрее removeLink(Link*)
      * @param link_id Идентификатор удаляемой связи
      */
     void removeLinkById(int link_id);
@@ -81,11 +102,28 @@ public:
     int getGrade() const;
 
     /**
-     * @brief Возвращает список связей узла
+     * @brief Возвращает копию списка связей узла
      * @return Вектор указателей на связи
      */
     std::vector<Link *> getLinks() const;
 
+    /**
+     * @brief Возвращает связи узла без копирования
+     * @return Диапазон связей, действителен до изменения связей узла
+     */
+    AdjacencySpan<Link> links() const { return m_links.items(); }
+
+    /**
+     * @brief Проверяет, числится ли связь в списке связей узла
+     *
+     * Ответ берется из слотов связи: адрес списка вычисляется по адресу узла,
+     * сам узел не читается, поэтому узел может быть уже удален.
+     * @param node Узел (может быть nullptr)
+     * @param link Связь
+     * @return true, если связь записана в список связей узла
+     */
+    static bool listsLink(const Node *node, const Link *link);
+
     /**
      * @brief Обновляет все связи узла
      *
@@ -95,10 +133,44 @@ public:
 
     /**
      * @brief Проверяет, должен ли узел реагировать на наведение
-     * @return true если узел должен реагировать на наведение, false в противном случае
+     *
+     * Использует маску сторон связей узла, поэтому выполняется за O(1).
+     * @return true если у узла есть связи на текущей стороне платы или в работе (WIP)
      */
     bool shouldReactToHover() const;
 
+    /**
+     * @brief Учитывает смену стороны подключенной связи
+     *
+     * Вызывается из Link::setSide до или после подключения связи к узлу;
+     * если связь к узлу не подключена, ничего не делает.
+     * @param link Связь с уже установленной новой стороной
+     * @param oldSide Прежняя сторона связи
+     */
+    void linkSideChanged(const Link *link, LinkSide oldSide);
+
+    /**
+     * @brief Откладывает обновление вида узлов при изменении их связей
+     *
+     * Используется при пакетной загрузке: после нее вызывающий обновляет вид
+     * затронутых узлов вызовом refresh().
+     * @param deferred true - откладывать, false - обновлять сразу
+     */
+    static void setRefreshDeferred(bool deferred);
+
+    /**
+     * @brief Возвращает маску сторон связей узла
+     * @return Биты sideBit() сторон, на которых у узла есть связи
+     */
+    quint8 sideMask() const { return m_sideMask; }
+
+    /**
+     * @brief Возвращает бит стороны платы в маске сторон
+     * @param side Сторона платы
+     * @return Бит стороны
+     */
+    static quint8 sideBit(LinkSide side) { return quint8(1u << static_cast<int>(side)); }
+
     /**
      * @brief Включает возможность перемещения узла
      */
@@ -118,7 +190,8 @@ public:
     /**
      * @brief Обновляет отображение узла
      *
-     * Обновляет видимость узла в зависимости от подключенных связей
+     * Обновляет видимость узла в зависимости от сторон подключенных связей.
+     * Вызывается автоматически, когда узел начинает или перестает соединять разные стороны.
      */
     void refresh();
 
@@ -147,6 +220,16 @@ public:
      */
     static void setNodeCount(int count);
 
+    /**
+     * @brief Отрисовывает узел с учетом уровня детализации
+     *
+     * Узлы, скрытые до наведения, и узлы меньше RenderLod::NodeMinPixels пикселей не рисуются.
+     * @param painter Указатель на рисовальщика
+     * @param option Указатель на опции стиля
+     * @param widget Указатель на виджет (опционально)
+     */
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
     int m_id;                  ///< Уникальный идентификатор узла
     std::optional<int> m_size; ///< Размер узла (опциональный)
 
@@ -190,16 +273,31 @@ protected:
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
 
 private:
-    std::vector<Link *> m_links; ///< Вектор связей, подключенных к узлу
+    AdjacencyList<Link> m_links; ///< Связи, подключенные к узлу
     LinkSide m_side;             ///< Сторона платы, к которой принадлежит узел
     QPointF m_drag_start_pos;    ///< Начальная позиция перетаскивания
+    quint8 m_sideMask = 0;       ///< Маска сторон подключенных связей
+    std::array<int, 6> m_sideCounts{}; ///< Число подключенных связей на каждой стороне (LinkSide)
+    bool m_hovered = false;      ///< Узел показан подсветкой наведения редактора
 
     /**
      * @brief Обработчик завершения перетаскивания
+     *
+     * Добавляет в стек отмены MoveNode; повторные перетаскивания того же узла
+     * подряд сливаются в один шаг отмены (MoveNode::mergeWith).
      * @param startPos Начальная позиция перетаскивания
      * @param endPos Конечная позиция перетаскивания
      */
     void dragFinished(const QPointF &startPos, const QPointF &endPos);
+
+    /**
+     * @brief Изменяет счетчик связей стороны и обновляет вид, если узел стал или перестал соединять стороны
+     * @param side Сторона платы
+     * @param delta Изменение числа связей
+     */
+    void countLinkSide(LinkSide side, int delta);
+
+    static bool s_refreshDeferred; ///< Обновление вида узлов отложено (пакетная загрузка)
 };
 
 #endif // NODE_H
\ No newline at end of file
@@ -0,0 +1,78 @@
+#include "NodeIndex.h"
+#include "Node.h"
+#include "Component.h"
+
+/*
+ * Статическая переменная NodeIndex::m_grid - сетка позиций узлов
+ * Размер ячейки порядка радиуса захвата: запрос просматривает не больше 2x2 ячеек
+ */
+UniformGrid<Node *> NodeIndex::m_grid(2 * NodeIndex::SnapRadius);
+
+/*
+ * Функция NodeIndex::update - добавление или перемещение узла
+ * Входные параметры:
+ *   node - узел или контакт
+ * Выходные данные:
+ *   отсутствуют
+ */
+void NodeIndex::update(Node *node)
+{
+    if (!node->scene() || node->type() == PhantomPad::Type)
+    {
+        m_grid.remove(node);
+        return;
+    }
+    m_grid.insert(node, node->scenePos());
+}
+
+/*
+ * Функция NodeIndex::remove - удаление узла
+ * Входные параметры:
+ *   node - узел или контакт
+ * Выходные данные:
+ *   отсутствуют
+ */
+void NodeIndex::remove(Node *node)
+{
+    m_grid.remove(node);
+}
+
+/*
+ * Функция NodeIndex::nearest - поиск ближайшего узла
+ * Входные параметры:
+ *   pos - точка в координатах сцены
+ *   radius - радиус поиска
+ * Выходные данные:
+ *   Node* - ближайший видимый узел или nullptr
+ */
+Node *NodeIndex::nearest(const QPointF &pos, qreal radius)
+{
+    // узлы скрытого слоя недоступны, как и при поиске через itemAt
+    std::optional<Node *> node = m_grid.nearest(pos, radius, [](Node *candidate)
+                                                { return candidate->isVisible(); });
+    return node ? *node : nullptr;
+}
+
+/*
+ * Функция NodeIndex::size - число узлов в индексе
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   size_t - число узлов
+ */
+size_t NodeIndex::size()
+{
+    return m_grid.size();
+}
+
+/*
+ * Функция NodeIndex::clear - очистка индекса
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   отсутствуют
+ */
+void NodeIndex::clear()
+{
+    m_grid.clear();
+}
@@ -0,0 +1,40 @@
+#ifndef NODEINDEX_H
+#define NODEINDEX_H
+
+#include <QPointF>
+#include "UniformGrid.h"
+
+class Node;
+
+/*
+ * Класс NodeIndex - пространственный индекс узлов и контактов
+ *
+ * Хранит позиции узлов (Node) и контактов (Pad), находящихся на сцене, в равномерной сетке
+ * и отвечает на запрос "ближайший узел в радиусе R" без обхода BSP-индекса сцены и проверки
+ * форм перекрывающихся элементов. Позиции обновляются из Node::itemChange.
+ * Фантомные контакты инструмента компонентов в индекс не попадают.
+ *
+ * Основные функции:
+ * 1. update(Node* node) - добавление или перемещение узла (удаление, если узел не на сцене)
+ * 2. remove(Node* node) - удаление узла
+ * 3. nearest(const QPointF& pos, qreal radius) - ближайший видимый узел в радиусе
+ * 4. size() - число узлов в индексе
+ * 5. clear() - очистка индекса
+ */
+class NodeIndex
+{
+public:
+    // Радиус захвата узла курсором, совпадает с расширенной формой Node::shape
+    static constexpr qreal SnapRadius = 10;
+
+    static void update(Node *node);
+    static void remove(Node *node);
+    static Node *nearest(const QPointF &pos, qreal radius = SnapRadius);
+    static size_t size();
+    static void clear();
+
+private:
+    static UniformGrid<Node *> m_grid;
+};
+
+#endif // NODEINDEX_H
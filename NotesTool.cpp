@@ -2,6 +2,7 @@
 #include "Editor.h"
 #include "Config.h"
 #include "CommunicationHub.h"
+#include "ItemRegistry.h"
 #include <QInputDialog>
 #include <QPainter>
 #include <QGraphicsScene>
@@ -9,7 +10,7 @@
 int NotesTool::note_count = 0;
 
 TextNote::TextNote(const QRectF& rect, const QColor& color, QGraphicsItem* parent)
-    : QGraphicsRectItem(rect, parent), m_color(color) {
+    : QGraphicsRectItem(rect, parent), m_id(-1), m_color(color) {
     setPen(QPen(m_color, 4, Qt::SolidLine));
     m_textItem = new QGraphicsTextItem(this);
     m_textItem->setFont(QFont("Arial", 10));
@@ -17,6 +18,16 @@ TextNote::TextNote(const QRectF& rect, const QColor& color, QGraphicsItem* paren
     setText("");
 }
 
+TextNote::~TextNote() {
+    ItemRegistry::instance().remove<TextNote>(m_id, this);
+}
+
+void TextNote::setId(int id) {
+    ItemRegistry::instance().remove<TextNote>(m_id, this);
+    m_id = id;
+    ItemRegistry::instance().add<TextNote>(m_id, this);
+}
+
 void TextNote::setText(const QString& text) {
     m_textItem->setPlainText(text);
     m_text = text;
@@ -87,7 +98,7 @@ void NotesTool::finishDrawing(QMouseEvent* event) {
         QString text = QInputDialog::getText(m_editor, "Add Note", "Enter note text:", QLineEdit::Normal, "", &ok);
         if (ok) {
             m_currentNote->setText(text);
-            m_currentNote->m_id = genNoteId();
+            m_currentNote->setId(genNoteId());
             m_notes.push_back(m_currentNote);
             CommunicationHub::instance().publish(HubEvent::NOTE_CREATED, m_currentNote);
         } else {
@@ -100,7 +111,7 @@ void NotesTool::finishDrawing(QMouseEvent* event) {
 
 void NotesTool::deleteNote(QMouseEvent* event) {
     QGraphicsItem* item = m_editor->itemAt(event->pos());
-    if (auto note = dynamic_cast<TextNote*>(item)) {
+    if (auto note = item_cast<TextNote>(item)) {
         m_editor->scene()->removeItem(note);
         m_notes.erase(std::remove(m_notes.begin(), m_notes.end(), note), m_notes.end());
         CommunicationHub::instance().publish(HubEvent::NOTE_DELETED, note);
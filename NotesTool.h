@@ -8,12 +8,17 @@
 #include <QPointF>
 #include <vector>
 #include "IEditorTool.h"
+#include "TypeChecks.h"
 
 class Editor;
 
 class TextNote : public QGraphicsRectItem {
 public:
     TextNote(const QRectF& rect, const QColor& color, QGraphicsItem* parent = nullptr);
+    enum { Type = TextNoteItem, LastType = Type };
+    int type() const override { return Type; }
+    ~TextNote();
+    void setId(int id);
     void setText(const QString& text);
     void adjustTextPos();
     void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget = nullptr) override;
@@ -1,24 +1,123 @@
 #include "QGraphicsItemLayer.h"
 #include "Editor.h"
+#include "Link.h"
+#include "RenderLod.h"
+#include <algorithm>
+#include <cmath>
 
 QGraphicsItemLayer::QGraphicsItemLayer(QGraphicsItem *parent)
     : QGraphicsItem(parent)
 {
-    // Создаем эффект прозрачности и устанавливаем его для слоя
-    m_opacityEffect = new QGraphicsOpacityEffect(this);
-    m_opacityEffect->setOpacity(1); // По умолчанию слой непрозрачный
-    setGraphicsEffect(m_opacityEffect);
+    // Трассы рисуются только в открытой области
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+QGraphicsItemLayer::~QGraphicsItemLayer()
+{
+    // Дочерние связи удаляются после слоя и не должны обращаться к нему
+    for (TrackBatch &batch : m_trackBatches)
+    {
+        for (auto &[key, cell] : batch.cells)
+        {
+            for (Link *link : cell.links)
+            {
+                link->m_trackLayer = nullptr;
+            }
+        }
+    }
 }
 
 QRectF QGraphicsItemLayer::boundingRect() const
 {
-    // Возвращаем пустой прямоугольник, так как слой сам по себе не имеет размеров
-    return QRectF(0, 0, 0, 0);
+    // Слой занимает область своих трасс
+    return m_tracksBounds;
 }
 
 void QGraphicsItemLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    // Пустая реализация, так как слой сам по себе ничего не рисует
+    qreal lod = RenderLod::levelOfDetail(painter);
+    bool antialiasing = painter->testRenderHint(QPainter::Antialiasing);
+
+    // Если открыта только часть слоя, просматриваем ячейки, в которых могут лежать
+    // трассы открытой области: центр области трассы не дальше m_trackReach от ее края
+    const QRectF &exposed = option->exposedRect;
+    bool cull = !exposed.contains(m_tracksBounds);
+    const QRectF reach = exposed.adjusted(-m_trackReach, -m_trackReach, m_trackReach, m_trackReach).intersected(m_tracksBounds);
+    const qint32 firstX = cellCoord(reach.left());
+    const qint32 lastX = cellCoord(reach.right());
+    const qint32 firstY = cellCoord(reach.top());
+    const qint32 lastY = cellCoord(reach.bottom());
+    const qreal cellsInReach = (qreal(lastX) - firstX + 1) * (qreal(lastY) - firstY + 1);
+    std::vector<QLineF> visible;
+
+    for (const TrackBatch &batch : m_trackBatches)
+    {
+        if (batch.cells.empty())
+        {
+            continue;
+        }
+
+        if (batch.pen.widthF() * lod >= RenderLod::TrackFullDetailPixels)
+        {
+            painter->setRenderHint(QPainter::Antialiasing, antialiasing);
+            painter->setPen(batch.pen);
+        }
+        else
+        {
+            // трасса уже пикселя: сглаживание и скругленные концы не видны, рисуем тонкой линией
+            painter->setRenderHint(QPainter::Antialiasing, false);
+            painter->setPen(QPen(batch.pen.color(), 0));
+        }
+
+        // Ячейки внутри открытой области рисуются целиком, у пограничных отбираются отрезки
+        visible.clear();
+        auto drawCell = [&](const TrackCell &cell)
+        {
+            if (!cull || exposed.contains(cell.bounds))
+            {
+                painter->drawLines(cell.lines.data(), int(cell.lines.size()));
+                return;
+            }
+            if (!cell.bounds.intersects(exposed))
+            {
+                return;
+            }
+            for (const QLineF &line : cell.lines)
+            {
+                if (trackRect(line, batch.pen).intersects(exposed))
+                {
+                    visible.push_back(line);
+                }
+            }
+        };
+
+        if (!cull || cellsInReach >= qreal(batch.cells.size()))
+        {
+            // Открыт весь слой или непустых ячеек меньше, чем ячеек в области, - обходим все
+            for (const auto &[key, cell] : batch.cells)
+            {
+                drawCell(cell);
+            }
+        }
+        else
+        {
+            for (qint32 y = firstY; y <= lastY; ++y)
+            {
+                for (qint32 x = firstX; x <= lastX; ++x)
+                {
+                    auto it = batch.cells.find(cellKey(x, y));
+                    if (it != batch.cells.end())
+                    {
+                        drawCell(it->second);
+                    }
+                }
+            }
+        }
+        if (!visible.empty())
+        {
+            painter->drawLines(visible.data(), int(visible.size()));
+        }
+    }
 }
 
 QPainterPath QGraphicsItemLayer::shape() const
@@ -29,6 +128,121 @@ QPainterPath QGraphicsItemLayer::shape() const
 
 void QGraphicsItemLayer::setOpacity(qreal opacity)
 {
-    // Устанавливаем прозрачность для всего слоя
-    m_opacityEffect->setOpacity(opacity);
-}
\ No newline at end of file
+    // Прозрачность наследуется дочерними элементами; при 1.0 отрисовка не меняется вовсе
+    QGraphicsItem::setOpacity(qBound(0.0, opacity, 1.0));
+}
+void QGraphicsItemLayer::setTrack(Link *link, const QLineF &line, const QPen &pen)
+{
+    int batchIndex = batchFor(pen);
+    QRectF rect = trackRect(line, pen);
+    QPointF center = rect.center();
+    quint64 key = cellKey(cellCoord(center.x()), cellCoord(center.y()));
+
+    if (link->m_trackLayer == this && link->m_trackBatch == batchIndex && link->m_trackCell == key)
+    {
+        // Та же группа и ячейка: заменяем отрезок на месте
+        TrackCell &cell = m_trackBatches[batchIndex].cells[key];
+        QLineF &stored = cell.lines[link->m_trackIndex];
+        update(trackRect(stored, pen));
+        stored = line;
+        cell.bounds = cell.bounds.united(rect);
+    }
+    else
+    {
+        if (link->m_trackLayer)
+        {
+            link->m_trackLayer->removeTrack(link);
+        }
+        TrackCell &cell = m_trackBatches[batchIndex].cells[key];
+        link->m_trackLayer = this;
+        link->m_trackBatch = batchIndex;
+        link->m_trackCell = key;
+        link->m_trackIndex = int(cell.lines.size());
+        cell.lines.push_back(line);
+        cell.links.push_back(link);
+        cell.bounds = cell.bounds.isNull() ? rect : cell.bounds.united(rect);
+    }
+
+    m_trackReach = std::max(m_trackReach, std::max(rect.width(), rect.height()) / 2);
+    if (!m_tracksBounds.contains(rect))
+    {
+        prepareGeometryChange();
+        m_tracksBounds = m_tracksBounds.isNull() ? rect : m_tracksBounds.united(rect);
+    }
+    update(rect);
+}
+
+void QGraphicsItemLayer::removeTrack(Link *link)
+{
+    if (link->m_trackLayer != this)
+    {
+        return;
+    }
+
+    // Последний отрезок ячейки переносится на место удаляемого
+    TrackBatch &batch = m_trackBatches[link->m_trackBatch];
+    auto cellIt = batch.cells.find(link->m_trackCell);
+    TrackCell &cell = cellIt->second;
+    int index = link->m_trackIndex;
+    update(trackRect(cell.lines[index], batch.pen));
+
+    cell.lines[index] = cell.lines.back();
+    cell.links[index] = cell.links.back();
+    cell.links[index]->m_trackIndex = index;
+    cell.lines.pop_back();
+    cell.links.pop_back();
+    if (cell.lines.empty())
+    {
+        batch.cells.erase(cellIt);
+    }
+
+    link->m_trackLayer = nullptr;
+    link->m_trackBatch = -1;
+    link->m_trackCell = 0;
+    link->m_trackIndex = -1;
+}
+
+int QGraphicsItemLayer::trackCount() const
+{
+    size_t count = 0;
+    for (const TrackBatch &batch : m_trackBatches)
+    {
+        for (const auto &[key, cell] : batch.cells)
+        {
+            count += cell.lines.size();
+        }
+    }
+    return int(count);
+}
+
+int QGraphicsItemLayer::batchFor(const QPen &pen)
+{
+    // Разных перьев на слое единицы (цвет стороны, подсветка, нестандартная ширина)
+    for (size_t i = 0; i < m_trackBatches.size(); ++i)
+    {
+        if (m_trackBatches[i].pen == pen)
+        {
+            return int(i);
+        }
+    }
+    m_trackBatches.push_back(TrackBatch{pen, {}});
+    return int(m_trackBatches.size() - 1);
+}
+
+QRectF QGraphicsItemLayer::trackRect(const QLineF &line, const QPen &pen)
+{
+    // Половина ширины пера плюс пиксель на сглаживание
+    qreal margin = pen.widthF() / 2 + 1;
+    return QRectF(line.p1(), line.p2()).normalized().adjusted(-margin, -margin, margin, margin);
+}
+
+qint32 QGraphicsItemLayer::cellCoord(qreal v)
+{
+    return qint32(std::floor(v / TrackCellSize));
+}
+
+quint64 QGraphicsItemLayer::cellKey(qint32 x, qint32 y)
+{
+    // Как в UniformGrid: координаты ячейки упакованы в одно число
+    return (quint64(quint32(x)) << 32) | quint32(y);
+}
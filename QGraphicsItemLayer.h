@@ -2,14 +2,31 @@
 #define QGRAPHICSITEMLAYER_H
 
 #include <QGraphicsItem>
-#include <QGraphicsOpacityEffect>
 #include <QPainterPath>
+#include <QPen>
+#include <unordered_map>
+#include <vector>
+#include "TypeChecks.h"
+
+class Link;
 
 /**
  * @brief Класс слоя графических элементов
  *
  * QGraphicsItemLayer представляет собой слой для группировки графических элементов
  * с возможностью управления прозрачностью всего слоя.
+ *
+ * Прозрачность слоя не использует QGraphicsEffect: она наследуется дочерними элементами
+ * и применяется к художнику при отрисовке каждого из них, поэтому слой не рисуется
+ * во внеэкранный буфер при каждой перерисовке.
+ *
+ * Слой сам рисует трассы своих связей (Link): отрезки хранятся в непрерывных массивах,
+ * сгруппированных по перу (цвет и ширина) и по ячейкам равномерной сетки, и выводятся
+ * вызовами drawLines. При отрисовке части слоя просматриваются только ячейки,
+ * пересекающие открытую область, поэтому время отрисовки зависит от ее размера,
+ * а не от общего числа трасс.
+ * Связи остаются элементами сцены без собственной отрисовки, поэтому поиск по индексу
+ * сцены, itemAt и команды отмены работают с ними как прежде.
  */
 class QGraphicsItemLayer : public QObject, public QGraphicsItem
 {
@@ -23,6 +40,21 @@ public:
      */
     QGraphicsItemLayer(QGraphicsItem *parent = nullptr);
 
+    enum { Type = ItemLayerItem, LastType = Type }; ///< Тип элемента для item_cast
+
+    /**
+     * @brief Возвращает тип элемента сцены
+     * @return QGraphicsItemLayer::Type
+     */
+    int type() const override { return Type; }
+
+    /**
+     * @brief Деструктор слоя
+     *
+     * Отвязывает связи, трассы которых рисует слой
+     */
+    ~QGraphicsItemLayer();
+
     /**
      * @brief Возвращает ограничивающий прямоугольник слоя
      * @return Ограничивающий прямоугольник
@@ -45,12 +77,65 @@ public:
 
     /**
      * @brief Устанавливает прозрачность слоя
+     *
+     * Значение умножается на прозрачность каждого дочернего элемента. Перекрывающиеся
+     * элементы полупрозрачного слоя смешиваются друг с другом, а не как единое изображение.
      * @param opacity Значение прозрачности (0.0 - полностью прозрачный, 1.0 - непрозрачный)
      */
     void setOpacity(qreal opacity);
 
+    /**
+     * @brief Добавляет или обновляет трассу связи
+     *
+     * Если связь рисуется другим слоем, она переносится в этот слой.
+     * @param link Связь
+     * @param line Отрезок в координатах слоя
+     * @param pen Перо трассы
+     */
+    void setTrack(Link *link, const QLineF &line, const QPen &pen);
+
+    /**
+     * @brief Удаляет трассу связи из слоя
+     * @param link Связь (ничего не делает, если связь рисуется другим слоем)
+     */
+    void removeTrack(Link *link);
+
+    /**
+     * @brief Возвращает число трасс, которые рисует слой
+     * @return Число трасс
+     */
+    int trackCount() const;
+
 private:
-    QGraphicsOpacityEffect *m_opacityEffect; ///< Эффект прозрачности для слоя
+    static constexpr qreal TrackCellSize = 512; ///< Размер ячейки сетки трасс в единицах сцены
+
+    /**
+     * @brief Трассы одной группы, центр области которых попадает в ячейку сетки
+     */
+    struct TrackCell
+    {
+        std::vector<QLineF> lines;  ///< Отрезки трасс
+        std::vector<Link *> links;  ///< Связи, индекс совпадает с индексом отрезка
+        QRectF bounds;              ///< Объединение областей добавленных трасс ячейки
+    };
+
+    /**
+     * @brief Трассы с одинаковым пером
+     */
+    struct TrackBatch
+    {
+        QPen pen;                                   ///< Перо трасс
+        std::unordered_map<quint64, TrackCell> cells; ///< Непустые ячейки сетки
+    };
+
+    int batchFor(const QPen &pen);
+    static QRectF trackRect(const QLineF &line, const QPen &pen);
+    static qint32 cellCoord(qreal v);
+    static quint64 cellKey(qint32 x, qint32 y);
+
+    std::vector<TrackBatch> m_trackBatches; ///< Группы трасс по перу
+    QRectF m_tracksBounds;                  ///< Объединение областей всех добавленных трасс
+    qreal m_trackReach = 0;                 ///< Наибольшее удаление края трассы от центра ее области
 };
 
 #endif // QGRAPHICSITEMLAYER_H
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef RENDERLOD_H
+#define RENDERLOD_H
+
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+/*
+ * Уровни детализации отрисовки
+ *
+ * Уровень детализации (lod) - число пикселей экрана на единицу сцены,
+ * см. QStyleOptionGraphicsItem::levelOfDetailFromTransform.
+ *
+ * 1. TrackFullDetailPixels - трассы тоньше этого числа пикселей рисуются
+ *    тонкой линией без сглаживания и скругленных концов
+ * 2. NodeMinPixels - узлы меньшего диаметра в пикселях не рисуются
+ * 3. levelOfDetail(painter) - уровень детализации для текущего преобразования художника
+ */
+namespace RenderLod
+{
+    constexpr qreal TrackFullDetailPixels = 1.5;
+    constexpr qreal NodeMinPixels = 2.0;
+
+    inline qreal levelOfDetail(const QPainter *painter)
+    {
+        return QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    }
+}
+
+#endif // RENDERLOD_H
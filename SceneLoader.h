@@ -3,6 +3,9 @@
 
 #include <QString>
 #include <QJsonObject>
+#include <functional>
+
+struct SceneSnapshot;
 
 /**
  * @brief Класс загрузчика сцены
@@ -20,6 +23,20 @@ public:
      */
     static bool loadSceneFromJson(const QString &filename);
 
+    /**
+     * @brief Разбирает JSON-файл сцены в снимок
+     *
+     * Не обращается к графическим элементам, поэтому может вызываться из рабочего потока.
+     * Элементы создаются затем вызовом SceneSnapshot::restore() в GUI-потоке.
+     * @param filename Путь к файлу сцены
+     * @param snapshot Снимок, в который добавляются элементы
+     * @param error Описание ошибки, если разбор не удался
+     * @param progress Вызывается с процентом выполнения, возврат false прерывает разбор
+     * @return true если разбор успешен, false в противном случае
+     */
+    static bool decodeJson(const QString &filename, SceneSnapshot &snapshot, QString &error,
+                           const std::function<bool(int)> &progress = {});
+
     /**
      * @brief Сохраняет сцену в JSON-файл
      * @param filename Путь к файлу для сохранения
@@ -27,6 +44,16 @@ public:
      */
     static bool saveSceneToJson(const QString &filename);
 
+    /**
+     * @brief Сохраняет снимок сцены в JSON-файл
+     *
+     * Не обращается к графическим элементам, поэтому может вызываться из рабочего потока.
+     * @param snapshot Снимок сцены
+     * @param filename Путь к файлу для сохранения
+     * @return true если сохранение успешно, false в противном случае
+     */
+    static bool saveSnapshotToJson(const SceneSnapshot &snapshot, const QString &filename);
+
     /**
      * @brief Получает элементы сцены в виде JSON-объекта
      * @return JSON-объект с элементами сцены
@@ -34,6 +61,13 @@ public:
     static QJsonObject getSceneElements();
 
 private:
+    /**
+     * @brief Преобразует снимок сцены в JSON-объект
+     * @param snapshot Снимок сцены
+     * @return JSON-объект с элементами сцены
+     */
+    static QJsonObject snapshotToJson(const SceneSnapshot &snapshot);
+
     /**
      * @brief Конструктор загрузчика сцены
      *
@@ -1,355 +1,779 @@
 #include "SceneLoaderBinary.h"
-#include "Editor.h"
-#include "Component.h"
-#include "Link.h"
-#include "Node.h"
-#include "ImageLayer.h"
-#include "CommunicationHub.h"
 #include <QFile>
 #include <QDebug>
-#include <QMessageBox>
-#include "NotesTool.h"
+#include "SceneSnapshot.h"
+#include "Trace.h"
+#include <QSaveFile>
+#include <QElapsedTimer>
+#include <QtEndian>
 #include <cstring>
+#include <algorithm>
 
-bool SceneLoaderBinary::loadSceneFromBinary(const QString &filename)
+namespace
 {
-    // Открываем файл для чтения
-    QFile file(filename);
-    if (file.open(QIODevice::ReadOnly))
+/// Версия, в которой сохраняются новые файлы
+constexpr qint32 CurrentBinaryVersion = 2;
+/// Размер заголовка v2: магическое число, версия, резерв, число секций
+constexpr quint64 HeaderSize = 16;
+/// Размер записи таблицы секций: тип, число элементов, смещение, размер
+constexpr quint64 SectionEntrySize = 24;
+/// Число секций, которые записывает saveSnapshotToBinary
+constexpr quint32 SectionCount = 8;
+/// Число разобранных элементов между вызовами функции прогресса
+constexpr quint64 DecodeProgressStep = 4096;
+
+quint64 alignedTo8(quint64 value)
+{
+    return (value + 7) & ~quint64(7);
+}
+
+/**
+ * @brief Запись таблицы секций формата v2
+ */
+struct SectionEntry
+{
+    SceneSectionType type; ///< Тип секции
+    quint32 count;         ///< Число элементов в секции
+    quint64 offset;        ///< Смещение секции от начала файла
+    quint64 size;          ///< Размер секции в байтах
+};
+
+/**
+ * @brief Ссылка на строку в таблице строк
+ */
+struct StringRef
+{
+    quint32 offset; ///< Смещение от начала таблицы строк
+    quint32 length; ///< Длина в байтах UTF-8
+};
+
+/**
+ * @brief Таблица строк формата v2 (UTF-8 без разделителей)
+ */
+class StringTable
+{
+public:
+    StringRef add(const QString &text)
     {
-        QDataStream in(&file);
-        in.setVersion(QDataStream::Qt_5_15);
+        QByteArray utf8 = text.toUtf8();
+        StringRef ref{quint32(m_data.size()), quint32(utf8.size())};
+        m_data.append(utf8);
+        return ref;
+    }
 
-        // Читаем и проверяем магическое число
-        char magic[7];
-        in.readRawData(magic, 6);
-        magic[6] = '\0'; // Завершаем строку нулем
-        if (strcmp(magic, "PCBTRC") != 0)
-        {
-            qDebug() << "Invalid file format";
-            return false;
-        }
+    const QByteArray &data() const { return m_data; }
+
+private:
+    QByteArray m_data;
+};
 
-        // Читаем и проверяем версию
-        qint32 version;
-        in >> version;
-        if (version != 1)
+/**
+ * @brief Построитель секции v2 из столбцов фиксированной ширины
+ *
+ * Каждый столбец выравнивается на 8 байт от начала секции и хранится в little-endian.
+ */
+class SectionBuilder
+{
+public:
+    template <typename T, typename Items, typename Getter>
+    void column(const Items &items, Getter get)
+    {
+        m_data.append(qsizetype(alignedTo8(m_data.size()) - m_data.size()), '\0');
+        qsizetype start = m_data.size();
+        m_data.resize(start + qsizetype(items.size() * sizeof(T)));
+        uchar *dst = reinterpret_cast<uchar *>(m_data.data()) + start;
+        for (const auto &item : items)
         {
-            qDebug() << "Unsupported file version";
-            return false;
+            qToLittleEndian<T>(static_cast<T>(get(item)), dst);
+            dst += sizeof(T);
         }
+    }
 
-        Editor *editor = Editor::instance();
+    const QByteArray &data() const { return m_data; }
 
-        // Создаем временный словарь для хранения узлов
-        QMap<int, Node *> nodeMap;
+private:
+    QByteArray m_data;
+};
 
-        // Читаем элементы сцены
-        while (!in.atEnd())
+/**
+ * @brief Чтение столбцов секции v2 из отображенного в память файла
+ *
+ * Столбцы запрашиваются в том же порядке, в котором были записаны. При выходе
+ * за границы секции ok() возвращает false.
+ */
+class SectionReader
+{
+public:
+    SectionReader() = default;
+    SectionReader(const uchar *data, quint64 size, quint32 count) : m_data(data), m_size(size), m_count(count) {}
+
+    template <typename T>
+    const uchar *column()
+    {
+        quint64 start = alignedTo8(m_pos);
+        quint64 end = start + quint64(m_count) * sizeof(T);
+        if (end > m_size)
         {
-            quint8 elementType;
-            in >> elementType;
-
-            // Обрабатываем элементы в зависимости от их типа
-            switch (static_cast<SceneElementType>(elementType))
-            {
-            case SceneElementType::Config:
-                readConfigFromBinary(in);
-                break;
-            case SceneElementType::Component:
-                readComponentFromBinary(in, nodeMap);
-                break;
-            case SceneElementType::Link:
-                readLinkFromBinary(in, nodeMap);
-                break;
-            case SceneElementType::Node:
-                readNodeFromBinary(in, nodeMap);
-                break;
-            case SceneElementType::ImageLayer:
-                readImageLayerFromBinary(in);
-                break;
-            case SceneElementType::TextNote:
-                readTextNoteFromBinary(in);
-                break;
-            case SceneElementType::LastIds:
-                readLastIds(in);
-                break;
-            default:
-                qDebug() << "Unknown element type:" << elementType;
-                return false;
-            }
+            m_ok = false;
+            return nullptr;
         }
+        m_pos = end;
+        return m_data + start;
+    }
+
+    const uchar *data() const { return m_data; }
+    quint64 size() const { return m_size; }
+    quint32 count() const { return m_count; }
+    bool ok() const { return m_ok; }
+
+private:
+    const uchar *m_data = nullptr;
+    quint64 m_size = 0;
+    quint32 m_count = 0;
+    quint64 m_pos = 0;
+    bool m_ok = true;
+};
+
+template <typename T>
+T valueAt(const uchar *column, quint32 index)
+{
+    return qFromLittleEndian<T>(column + quint64(index) * sizeof(T));
+}
 
-        file.close();
+QByteArray buildNodesSection(const SceneSnapshot &snapshot)
+{
+    SectionBuilder section;
+    section.column<qint32>(snapshot.nodes, [](const NodeRecord &node) { return node.id; });
+    section.column<double>(snapshot.nodes, [](const NodeRecord &node) { return node.x; });
+    section.column<double>(snapshot.nodes, [](const NodeRecord &node) { return node.y; });
+    return section.data();
+}
 
-        // Уведомляем об изменениях для всех узлов
-        for (auto node : nodeMap)
+QByteArray buildComponentsSection(const SceneSnapshot &snapshot, StringTable &strings)
+{
+    std::vector<StringRef> names;
+    std::vector<quint32> firstPads;
+    names.reserve(snapshot.components.size());
+    firstPads.reserve(snapshot.components.size());
+    quint32 firstPad = 0;
+    for (const ComponentRecord &component : snapshot.components)
+    {
+        names.push_back(strings.add(component.name));
+        firstPads.push_back(firstPad);
+        firstPad += quint32(component.pads.size());
+    }
+
+    SectionBuilder section;
+    section.column<qint32>(snapshot.components, [](const ComponentRecord &component) { return component.id; });
+    section.column<quint32>(names, [](const StringRef &ref) { return ref.offset; });
+    section.column<quint32>(names, [](const StringRef &ref) { return ref.length; });
+    section.column<double>(snapshot.components, [](const ComponentRecord &component) { return component.x; });
+    section.column<double>(snapshot.components, [](const ComponentRecord &component) { return component.y; });
+    section.column<quint32>(firstPads, [](quint32 first) { return first; });
+    section.column<quint32>(snapshot.components, [](const ComponentRecord &component) { return component.pads.size(); });
+    return section.data();
+}
+
+QByteArray buildPadsSection(const SceneSnapshot &snapshot, StringTable &strings, quint32 &count)
+{
+    // Контакты хранятся подряд в порядке компонентов
+    std::vector<const PadRecord *> pads;
+    for (const ComponentRecord &component : snapshot.components)
+    {
+        for (const PadRecord &pad : component.pads)
         {
-            if (node && !dynamic_cast<Pad *>(node))
-            {
-                node->notifyLinkChanges();
-            }
+            pads.push_back(&pad);
         }
+    }
+    std::vector<StringRef> names;
+    names.reserve(pads.size());
+    for (const PadRecord *pad : pads)
+    {
+        names.push_back(strings.add(pad->name));
+    }
+    count = quint32(pads.size());
+
+    SectionBuilder section;
+    section.column<qint32>(pads, [](const PadRecord *pad) { return pad->id; });
+    section.column<qint32>(pads, [](const PadRecord *pad) { return pad->number; });
+    section.column<quint32>(names, [](const StringRef &ref) { return ref.offset; });
+    section.column<quint32>(names, [](const StringRef &ref) { return ref.length; });
+    section.column<double>(pads, [](const PadRecord *pad) { return pad->x; });
+    section.column<double>(pads, [](const PadRecord *pad) { return pad->y; });
+    return section.data();
+}
 
-        qDebug() << "Scene loaded from" << filename;
-        editor->showStatusMessage("Scene loaded successfully");
+QByteArray buildLinksSection(const SceneSnapshot &snapshot)
+{
+    SectionBuilder section;
+    section.column<qint32>(snapshot.links, [](const LinkRecord &link) { return link.id; });
+    section.column<qint32>(snapshot.links, [](const LinkRecord &link) { return link.fromNodeId; });
+    section.column<qint32>(snapshot.links, [](const LinkRecord &link) { return link.toNodeId; });
+    section.column<qint32>(snapshot.links, [](const LinkRecord &link) { return link.graphId; });
+    section.column<qint32>(snapshot.links, [](const LinkRecord &link) { return link.width.value_or(0); });
+    section.column<quint8>(snapshot.links, [](const LinkRecord &link) { return quint8(link.side); });
+    section.column<quint8>(snapshot.links, [](const LinkRecord &link) { return quint8(link.width.has_value()); });
+    return section.data();
+}
 
-        // Очищаем временный словарь узлов
-        nodeMap.clear();
-        return true;
+QByteArray buildImageLayersSection(const SceneSnapshot &snapshot, StringTable &strings)
+{
+    std::vector<StringRef> paths;
+    for (const ImageLayerRecord &imageLayer : snapshot.imageLayers)
+    {
+        paths.push_back(strings.add(imageLayer.imagePath));
     }
-    else
+
+    SectionBuilder section;
+    section.column<qint32>(snapshot.imageLayers, [](const ImageLayerRecord &imageLayer) { return imageLayer.id; });
+    section.column<quint32>(paths, [](const StringRef &ref) { return ref.offset; });
+    section.column<quint32>(paths, [](const StringRef &ref) { return ref.length; });
+    section.column<double>(snapshot.imageLayers, [](const ImageLayerRecord &imageLayer) { return imageLayer.x; });
+    section.column<double>(snapshot.imageLayers, [](const ImageLayerRecord &imageLayer) { return imageLayer.y; });
+    section.column<double>(snapshot.imageLayers, [](const ImageLayerRecord &imageLayer) { return imageLayer.opacity; });
+    return section.data();
+}
+
+QByteArray buildTextNotesSection(const SceneSnapshot &snapshot, StringTable &strings)
+{
+    std::vector<StringRef> texts;
+    for (const TextNoteRecord &textNote : snapshot.notes)
     {
-        qDebug() << "Failed to open file for reading:" << filename;
-        return false;
+        texts.push_back(strings.add(textNote.text));
     }
+
+    SectionBuilder section;
+    section.column<qint32>(snapshot.notes, [](const TextNoteRecord &textNote) { return textNote.id; });
+    section.column<double>(snapshot.notes, [](const TextNoteRecord &textNote) { return textNote.rect.x(); });
+    section.column<double>(snapshot.notes, [](const TextNoteRecord &textNote) { return textNote.rect.y(); });
+    section.column<double>(snapshot.notes, [](const TextNoteRecord &textNote) { return textNote.rect.width(); });
+    section.column<double>(snapshot.notes, [](const TextNoteRecord &textNote) { return textNote.rect.height(); });
+    section.column<quint32>(texts, [](const StringRef &ref) { return ref.offset; });
+    section.column<quint32>(texts, [](const StringRef &ref) { return ref.length; });
+    return section.data();
 }
+} // namespace
 
-bool SceneLoaderBinary::saveSceneToBinary(const QString &filename)
+bool SceneLoaderBinary::decodeBinary(const QString &filename, SceneSnapshot &snapshot, QString &error,
+                                     const std::function<bool(int)> &progress)
 {
-    // Добавляем расширение .pcb если его нет
-    QString actualFilename = filename;
-    if (!actualFilename.toLower().endsWith(".pcb"))
+    // Открываем файл для чтения
+    QFile file(filename);
+    if (!file.open(QIODevice::ReadOnly))
     {
-        actualFilename += ".pcb";
+        error = QString("Failed to open file for reading: %1").arg(file.errorString());
+        return false;
     }
 
-    // Открываем файл для записи
-    QFile file(actualFilename);
-    if (file.open(QIODevice::WriteOnly))
+    // Читаем и проверяем магическое число
+    QByteArray header = file.read(10);
+    if (header.size() < 10 || !header.startsWith("PCBTRC"))
     {
-        QDataStream out(&file);
-        out.setVersion(QDataStream::Qt_5_15);
+        error = "Invalid file format";
+        return false;
+    }
 
-        // Записываем магическое число для идентификации формата файла
-        out.writeRawData("PCBTRC", 6);
+    // Версия записана в big-endian, как ее пишет QDataStream в версии 1
+    qint32 version = qFromBigEndian<qint32>(header.constData() + 6);
+    if (version == 1)
+    {
+        return readVersion1(file, snapshot, error, progress);
+    }
+    else if (version == 2)
+    {
+        return readVersion2(file, snapshot, error, progress);
+    }
+    error = QString("Unsupported file version %1").arg(version);
+    return false;
+}
 
-        // Записываем номер версии
-        out << (qint32)1; // версия 1
+bool SceneLoaderBinary::readVersion1(QFile &file, SceneSnapshot &snapshot, QString &error,
+                                     const std::function<bool(int)> &progress)
+{
+    // Поток продолжает чтение сразу после магического числа и версии
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_15);
+    const qint64 fileSize = std::max<qint64>(file.size(), 1);
+
+    // Читаем элементы сцены
+    quint64 recordCount = 0;
+    while (!in.atEnd())
+    {
+        quint8 elementType;
+        in >> elementType;
 
-        // Записываем последние ID
-        writeLastIds(out);
+        // Обрабатываем элементы в зависимости от их типа
+        switch (static_cast<SceneElementType>(elementType))
+        {
+        case SceneElementType::Config:
+            readConfigFromBinary(in, snapshot);
+            break;
+        case SceneElementType::Component:
+            readComponentFromBinary(in, snapshot);
+            break;
+        case SceneElementType::Link:
+            readLinkFromBinary(in, snapshot);
+            break;
+        case SceneElementType::Node:
+            readNodeFromBinary(in, snapshot);
+            break;
+        case SceneElementType::ImageLayer:
+            readImageLayerFromBinary(in, snapshot);
+            break;
+        case SceneElementType::TextNote:
+            readTextNoteFromBinary(in, snapshot);
+            break;
+        case SceneElementType::LastIds:
+            readLastIds(in, snapshot);
+            break;
+        default:
+            error = QString("Unknown element type: %1").arg(elementType);
+            return false;
+        }
+
+        if (++recordCount % DecodeProgressStep == 0 && progress && !progress(int(file.pos() * 100 / fileSize)))
+        {
+            error = "Loading cancelled";
+            return false;
+        }
+    }
+
+    if (in.status() != QDataStream::Ok)
+    {
+        error = "Unexpected end of file";
+        return false;
+    }
+    return true;
+}
+
+bool SceneLoaderBinary::readVersion2(QFile &file, SceneSnapshot &snapshot, QString &error,
+                                     const std::function<bool(int)> &progress)
+{
+    // Отображаем файл в память целиком, записи читаются прямо из отображения
+    const quint64 fileSize = quint64(file.size());
+    const uchar *data = fileSize >= HeaderSize ? file.map(0, file.size()) : nullptr;
+    if (!data)
+    {
+        error = QString("Failed to map file: %1").arg(file.errorString());
+        return false;
+    }
+
+    // Читаем таблицу секций
+    quint32 sectionCount = qFromLittleEndian<quint32>(data + 12);
+    if (HeaderSize + quint64(sectionCount) * SectionEntrySize > fileSize)
+    {
+        error = "Invalid section table";
+        return false;
+    }
+    QMap<SceneSectionType, SectionReader> sections;
+    for (quint32 i = 0; i < sectionCount; ++i)
+    {
+        const uchar *entry = data + HeaderSize + quint64(i) * SectionEntrySize;
+        auto type = static_cast<SceneSectionType>(qFromLittleEndian<quint32>(entry));
+        quint32 count = qFromLittleEndian<quint32>(entry + 4);
+        quint64 offset = qFromLittleEndian<quint64>(entry + 8);
+        quint64 size = qFromLittleEndian<quint64>(entry + 16);
+        if (offset > fileSize || size > fileSize - offset)
+        {
+            error = QString("Section %1 is out of file bounds").arg(quint32(type));
+            return false;
+        }
+        // Неизвестные секции пропускаются, чтобы новые версии оставались читаемыми
+        sections[type] = SectionReader(data + offset, size, count);
+    }
 
-        QGraphicsScene *scene = Editor::instance()->scene();
+    // Последние ID и конфигурация хранятся так же, как в версии 1
+    SectionReader meta = sections.value(SceneSectionType::Meta);
+    QByteArray metaBytes = QByteArray::fromRawData(reinterpret_cast<const char *>(meta.data()), qsizetype(meta.size()));
+    QDataStream in(metaBytes);
+    in.setVersion(QDataStream::Qt_5_15);
+    readLastIds(in, snapshot);
+    readConfigFromBinary(in, snapshot);
+    if (in.status() != QDataStream::Ok)
+    {
+        error = "Invalid meta section";
+        return false;
+    }
 
-        // Записываем конфигурацию
-        out << (quint8)SceneElementType::Config;
-        writeConfigToBinary(out);
+    // Получаем столбцы всех секций до разбора элементов
+    SectionReader strings = sections.value(SceneSectionType::Strings);
+
+    SectionReader nodes = sections.value(SceneSectionType::Nodes);
+    const uchar *nodeIds = nodes.column<qint32>();
+    const uchar *nodeX = nodes.column<double>();
+    const uchar *nodeY = nodes.column<double>();
+
+    SectionReader components = sections.value(SceneSectionType::Components);
+    const uchar *componentIds = components.column<qint32>();
+    const uchar *componentNameOffsets = components.column<quint32>();
+    const uchar *componentNameLengths = components.column<quint32>();
+    const uchar *componentX = components.column<double>();
+    const uchar *componentY = components.column<double>();
+    const uchar *componentFirstPads = components.column<quint32>();
+    const uchar *componentPadCounts = components.column<quint32>();
+
+    SectionReader pads = sections.value(SceneSectionType::Pads);
+    const uchar *padIds = pads.column<qint32>();
+    const uchar *padNumbers = pads.column<qint32>();
+    const uchar *padNameOffsets = pads.column<quint32>();
+    const uchar *padNameLengths = pads.column<quint32>();
+    const uchar *padX = pads.column<double>();
+    const uchar *padY = pads.column<double>();
+
+    SectionReader links = sections.value(SceneSectionType::Links);
+    const uchar *linkIds = links.column<qint32>();
+    const uchar *linkFrom = links.column<qint32>();
+    const uchar *linkTo = links.column<qint32>();
+    const uchar *linkGraphIds = links.column<qint32>();
+    const uchar *linkWidths = links.column<qint32>();
+    const uchar *linkSides = links.column<quint8>();
+    const uchar *linkHasWidth = links.column<quint8>();
+
+    SectionReader imageLayers = sections.value(SceneSectionType::ImageLayers);
+    const uchar *imageLayerIds = imageLayers.column<qint32>();
+    const uchar *imageLayerPathOffsets = imageLayers.column<quint32>();
+    const uchar *imageLayerPathLengths = imageLayers.column<quint32>();
+    const uchar *imageLayerX = imageLayers.column<double>();
+    const uchar *imageLayerY = imageLayers.column<double>();
+    const uchar *imageLayerOpacity = imageLayers.column<double>();
+
+    SectionReader textNotes = sections.value(SceneSectionType::TextNotes);
+    const uchar *textNoteIds = textNotes.column<qint32>();
+    const uchar *textNoteX = textNotes.column<double>();
+    const uchar *textNoteY = textNotes.column<double>();
+    const uchar *textNoteWidths = textNotes.column<double>();
+    const uchar *textNoteHeights = textNotes.column<double>();
+    const uchar *textNoteTextOffsets = textNotes.column<quint32>();
+    const uchar *textNoteTextLengths = textNotes.column<quint32>();
+
+    if (!nodes.ok() || !components.ok() || !pads.ok() || !links.ok() || !imageLayers.ok() || !textNotes.ok())
+    {
+        error = "Section is smaller than its element count";
+        return false;
+    }
 
-        // Сначала записываем узлы
-        for (QGraphicsItem *item : scene->items())
+    // Строки копируются из таблицы строк, ссылки за ее пределы считаются ошибкой
+    bool stringsOk = true;
+    auto string = [&strings, &stringsOk](const uchar *offsets, const uchar *lengths, quint32 index)
+    {
+        quint32 offset = valueAt<quint32>(offsets, index);
+        quint32 length = valueAt<quint32>(lengths, index);
+        if (quint64(offset) + length > strings.size())
         {
-            if (auto node = dynamic_cast<Node *>(item))
-            {
-                if (!dynamic_cast<Pad *>(node))
-                {
-                    out << (quint8)SceneElementType::Node;
-                    writeNodeToBinary(out, node);
-                }
-            }
+            stringsOk = false;
+            return QString();
         }
+        return QString::fromUtf8(reinterpret_cast<const char *>(strings.data()) + offset, length);
+    };
+
+    // Прогресс считается по всем элементам всех секций
+    const quint64 total = std::max<quint64>(quint64(nodes.count()) + components.count() + pads.count() + links.count(), 1);
+    quint64 done = 0;
+    auto step = [&]()
+    {
+        return ++done % DecodeProgressStep != 0 || !progress || progress(int(done * 100 / total));
+    };
 
-        // Записываем компоненты (включая контакты)
-        for (QGraphicsItem *item : scene->items())
+    // Узлы
+    snapshot.nodes.reserve(nodes.count());
+    for (quint32 i = 0; i < nodes.count(); ++i)
+    {
+        snapshot.nodes.push_back({valueAt<qint32>(nodeIds, i), valueAt<double>(nodeX, i), valueAt<double>(nodeY, i)});
+        if (!step())
         {
-            if (auto component = dynamic_cast<Component *>(item))
-            {
-                out << (quint8)SceneElementType::Component;
-                writeComponentToBinary(out, component);
-            }
+            error = "Loading cancelled";
+            return false;
         }
+    }
 
-        // Записываем связи
-        for (QGraphicsItem *item : scene->items())
+    // Компоненты с контактами
+    snapshot.components.reserve(components.count());
+    for (quint32 i = 0; i < components.count(); ++i)
+    {
+        quint32 firstPad = valueAt<quint32>(componentFirstPads, i);
+        quint32 padCount = valueAt<quint32>(componentPadCounts, i);
+        if (quint64(firstPad) + padCount > pads.count())
         {
-            if (auto link = dynamic_cast<Link *>(item))
-            {
-                out << (quint8)SceneElementType::Link;
-                writeLinkToBinary(out, link);
-            }
+            error = "Component pad range is out of bounds";
+            return false;
         }
 
-        // Записываем слои изображений
-        for (QGraphicsItem *item : scene->items())
+        ComponentRecord component{valueAt<qint32>(componentIds, i), string(componentNameOffsets, componentNameLengths, i),
+                                  valueAt<double>(componentX, i), valueAt<double>(componentY, i), {}};
+        component.pads.reserve(padCount);
+        for (quint32 p = firstPad; p < firstPad + padCount; ++p)
         {
-            if (auto imageLayer = dynamic_cast<ImageLayer *>(item))
-            {
-                out << (quint8)SceneElementType::ImageLayer;
-                writeImageLayerToBinary(out, imageLayer);
-            }
+            component.pads.push_back({valueAt<qint32>(padIds, p), valueAt<double>(padX, p), valueAt<double>(padY, p),
+                                      valueAt<qint32>(padNumbers, p), string(padNameOffsets, padNameLengths, p)});
+            ++done;
+        }
+        snapshot.components.push_back(std::move(component));
+        if (!step())
+        {
+            error = "Loading cancelled";
+            return false;
         }
+    }
 
-        // Записываем текстовые заметки
-        for (QGraphicsItem *item : scene->items())
+    // Связи
+    snapshot.links.reserve(links.count());
+    for (quint32 i = 0; i < links.count(); ++i)
+    {
+        std::optional<int> width;
+        if (valueAt<quint8>(linkHasWidth, i))
+        {
+            width = valueAt<qint32>(linkWidths, i);
+        }
+        snapshot.links.push_back({valueAt<qint32>(linkIds, i), valueAt<qint32>(linkFrom, i), valueAt<qint32>(linkTo, i),
+                                  valueAt<qint32>(linkGraphIds, i), static_cast<LinkSide>(valueAt<quint8>(linkSides, i)), width});
+        if (!step())
         {
-            if (auto textNote = dynamic_cast<TextNote *>(item))
-            {
-                out << (quint8)SceneElementType::TextNote;
-                writeTextNoteToBinary(out, textNote);
-            }
+            error = "Loading cancelled";
+            return false;
         }
+    }
 
-        file.close();
-        qDebug() << "Scene data saved to" << actualFilename;
-        return true;
+    // Слои изображений
+    for (quint32 i = 0; i < imageLayers.count(); ++i)
+    {
+        snapshot.imageLayers.push_back({valueAt<qint32>(imageLayerIds, i), string(imageLayerPathOffsets, imageLayerPathLengths, i),
+                                        valueAt<double>(imageLayerX, i), valueAt<double>(imageLayerY, i), valueAt<double>(imageLayerOpacity, i)});
     }
-    else
+
+    // Текстовые заметки
+    for (quint32 i = 0; i < textNotes.count(); ++i)
     {
-        qDebug() << "Failed to save scene data to" << actualFilename;
+        QRectF rect(valueAt<double>(textNoteX, i), valueAt<double>(textNoteY, i),
+                    valueAt<double>(textNoteWidths, i), valueAt<double>(textNoteHeights, i));
+        snapshot.notes.push_back({valueAt<qint32>(textNoteIds, i), rect, string(textNoteTextOffsets, textNoteTextLengths, i)});
+    }
+
+    if (!stringsOk)
+    {
+        error = "String reference is out of bounds";
         return false;
     }
+    return true;
 }
 
-void SceneLoaderBinary::writeComponentToBinary(QDataStream &out, Component *component)
+bool SceneLoaderBinary::saveSnapshotToBinary(const SceneSnapshot &snapshot, const QString &filename, qint32 version)
 {
-    // Записываем данные компонента
-    out << component->m_id << component->m_name
-        << component->pos().x() << component->pos().y();
+    QElapsedTimer timer;
+    timer.start();
 
-    // Записываем контакты компонента
-    out << (quint32)component->m_pads.size();
-    for (const auto &pad : component->m_pads)
+    if (version != 1 && version != CurrentBinaryVersion)
     {
-        writePadToBinary(out, pad);
+        qDebug() << "Unsupported file version" << version;
+        return false;
     }
-}
-
-void SceneLoaderBinary::writePadToBinary(QDataStream &out, Pad *pad)
-{
-    // Записываем данные контакта
-    out << pad->m_id << pad->pos().x() << pad->pos().y()
-        << pad->m_number << pad->m_name;
-}
 
-void SceneLoaderBinary::writeLinkToBinary(QDataStream &out, Link *link)
-{
-    // Записываем данные связи
-    out << link->m_id << link->fromNode()->m_id << link->toNode()->m_id
-        << link->m_graphId << (quint8)link->m_side;
+    // Добавляем расширение .pcb если его нет
+    QString actualFilename = filename;
+    if (!actualFilename.toLower().endsWith(".pcb"))
+    {
+        actualFilename += ".pcb";
+    }
 
-    // Записываем ширину, если она задана
-    if (link->m_width.has_value())
+    // Открываем файл для записи (QSaveFile заменяет файл атомарно при commit)
+    QSaveFile file(actualFilename);
+    if (!file.open(QIODevice::WriteOnly))
     {
-        out << (quint8)1; // Индикатор наличия значения ширины
-        out << (qreal)link->m_width.value();
+        qDebug() << "Failed to save scene data to" << actualFilename;
+        return false;
     }
-    else
+
+    bool ok = version == 1 ? writeVersion1(file, snapshot) : writeVersion2(file, snapshot);
+    if (!ok || !file.commit())
     {
-        out << (quint8)0; // Индикатор отсутствия значения ширины
+        qDebug() << "Failed to save scene data to" << actualFilename;
+        return false;
     }
-}
 
-void SceneLoaderBinary::writeNodeToBinary(QDataStream &out, Node *node)
-{
-    // Записываем данные узла
-    out << node->m_id << node->pos().x() << node->pos().y();
+    qint64 elapsed = timer.elapsed();
+    qsizetype linkCount = snapshot.links.size();
+    qCDebug(lcLoad) << "Scene data saved to" << actualFilename << "(version" << version << ") in" << elapsed << "ms,"
+                    << linkCount << "links" << (linkCount > 0 ? elapsed * 100000.0 / linkCount : 0.0) << "ms per 100k links";
+    return true;
 }
 
-void SceneLoaderBinary::writeImageLayerToBinary(QDataStream &out, ImageLayer *imageLayer)
+bool SceneLoaderBinary::writeVersion1(QFileDevice &file, const SceneSnapshot &snapshot)
 {
-    // Записываем данные слоя изображения
-    out << (qint32)imageLayer->m_id << imageLayer->m_imagePath
-        << imageLayer->pos().x() << imageLayer->pos().y()
-        << imageLayer->opacity();
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_15);
+
+    // Магическое число и версия, затем записи с префиксом типа в порядке, в котором их читает readVersion1
+    out.writeRawData("PCBTRC", 6);
+    out << qint32(1);
+
+    out << quint8(SceneElementType::LastIds);
+    writeLastIds(out, snapshot);
+    out << quint8(SceneElementType::Config);
+    writeConfigToBinary(out, snapshot);
+
+    for (const NodeRecord &node : snapshot.nodes)
+    {
+        out << quint8(SceneElementType::Node) << node.id << node.x << node.y;
+    }
+    for (const ComponentRecord &component : snapshot.components)
+    {
+        out << quint8(SceneElementType::Component) << component.id << component.name << component.x << component.y;
+        out << quint32(component.pads.size());
+        for (const PadRecord &pad : component.pads)
+        {
+            out << pad.id << pad.x << pad.y << pad.number << pad.name;
+        }
+    }
+    for (const LinkRecord &link : snapshot.links)
+    {
+        out << quint8(SceneElementType::Link) << link.id << link.fromNodeId << link.toNodeId << link.graphId
+            << quint8(link.side);
+        // Ширина записывается с признаком наличия
+        out << quint8(link.width.has_value());
+        if (link.width)
+        {
+            out << qreal(*link.width);
+        }
+    }
+    for (const ImageLayerRecord &imageLayer : snapshot.imageLayers)
+    {
+        out << quint8(SceneElementType::ImageLayer) << qint32(imageLayer.id) << imageLayer.imagePath
+            << imageLayer.x << imageLayer.y << imageLayer.opacity;
+    }
+    for (const TextNoteRecord &note : snapshot.notes)
+    {
+        out << quint8(SceneElementType::TextNote) << note.id << note.rect.x() << note.rect.y()
+            << note.rect.width() << note.rect.height() << note.text;
+    }
+    return out.status() == QDataStream::Ok;
 }
 
-void SceneLoaderBinary::writeTextNoteToBinary(QDataStream &out, TextNote *textNote)
+bool SceneLoaderBinary::writeVersion2(QFileDevice &file, const SceneSnapshot &snapshot)
 {
-    // Записываем данные текстовой заметки
-    out << textNote->m_id
-        << textNote->rect().x()
-        << textNote->rect().y()
-        << textNote->rect().width()
-        << textNote->rect().height()
-        << textNote->m_text;
+    // Место под заголовок и таблицу секций, они записываются в конце, когда известны смещения
+    quint64 offset = alignedTo8(HeaderSize + SectionCount * SectionEntrySize);
+    bool ok = file.write(QByteArray(qsizetype(offset), '\0')) == qint64(offset);
+
+    // Секции строятся и записываются по одной, поэтому в памяти держится только текущая
+    std::vector<SectionEntry> table;
+    auto writeSection = [&](SceneSectionType type, quint32 count, const QByteArray &section)
+    {
+        quint64 padding = alignedTo8(offset) - offset;
+        ok = ok && file.write(QByteArray(qsizetype(padding), '\0')) == qint64(padding);
+        offset += padding;
+        table.push_back({type, count, offset, quint64(section.size())});
+        ok = ok && file.write(section) == section.size();
+        offset += section.size();
+    };
+
+    // Последние ID и конфигурация
+    QByteArray meta;
+    {
+        QDataStream out(&meta, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_5_15);
+        writeLastIds(out, snapshot);
+        writeConfigToBinary(out, snapshot);
+    }
+    writeSection(SceneSectionType::Meta, 0, meta);
+
+    StringTable strings;
+    quint32 padCount = 0;
+    writeSection(SceneSectionType::Nodes, quint32(snapshot.nodes.size()), buildNodesSection(snapshot));
+    writeSection(SceneSectionType::Components, quint32(snapshot.components.size()), buildComponentsSection(snapshot, strings));
+    QByteArray padsSection = buildPadsSection(snapshot, strings, padCount);
+    writeSection(SceneSectionType::Pads, padCount, padsSection);
+    writeSection(SceneSectionType::Links, quint32(snapshot.links.size()), buildLinksSection(snapshot));
+    writeSection(SceneSectionType::ImageLayers, quint32(snapshot.imageLayers.size()), buildImageLayersSection(snapshot, strings));
+    writeSection(SceneSectionType::TextNotes, quint32(snapshot.notes.size()), buildTextNotesSection(snapshot, strings));
+    writeSection(SceneSectionType::Strings, quint32(strings.data().size()), strings.data());
+
+    // Заголовок и таблица секций
+    QByteArray header(qsizetype(HeaderSize + table.size() * SectionEntrySize), '\0');
+    uchar *headerData = reinterpret_cast<uchar *>(header.data());
+    std::memcpy(headerData, "PCBTRC", 6);
+    qToBigEndian<qint32>(CurrentBinaryVersion, headerData + 6);
+    qToLittleEndian<quint32>(quint32(table.size()), headerData + 12);
+    for (size_t i = 0; i < table.size(); ++i)
+    {
+        uchar *entry = headerData + HeaderSize + i * SectionEntrySize;
+        qToLittleEndian<quint32>(quint32(table[i].type), entry);
+        qToLittleEndian<quint32>(table[i].count, entry + 4);
+        qToLittleEndian<quint64>(table[i].offset, entry + 8);
+        qToLittleEndian<quint64>(table[i].size, entry + 16);
+    }
+    return ok && file.seek(0) && file.write(header) == header.size();
 }
 
-void SceneLoaderBinary::writeLastIds(QDataStream &out)
+void SceneLoaderBinary::writeLastIds(QDataStream &out, const SceneSnapshot &snapshot)
 {
     // Записываем последние ID
-    out << (quint8)SceneElementType::LastIds;
-    out << Component::getLastComponentId()
-        << Link::getLastLinkId()
-        << NotesTool::getLastNoteId()
-        << Node::getLastNodeId();
+    out << snapshot.lastComponentId
+        << snapshot.lastLinkId
+        << snapshot.lastNoteId
+        << snapshot.lastNodeId;
 }
 
-void SceneLoaderBinary::writeConfigToBinary(QDataStream &out)
+void SceneLoaderBinary::writeConfigToBinary(QDataStream &out, const SceneSnapshot &snapshot)
 {
     // Записываем данные конфигурации
-    out << Config::instance()->color(Color::FRONT);
-    out << Config::instance()->color(Color::BACK);
-    out << Config::instance()->color(Color::HIGHLIGHTED);
-    out << Config::instance()->color(Color::NODE);
-    out << Config::instance()->color(Color::NOTES);
-    out << Config::instance()->color(Color::WIP);
-    out << Config::instance()->m_linkWidth;
-    out << Config::instance()->m_padSize;
+    out << snapshot.colors.value(Color::FRONT);
+    out << snapshot.colors.value(Color::BACK);
+    out << snapshot.colors.value(Color::HIGHLIGHTED);
+    out << snapshot.colors.value(Color::NODE);
+    out << snapshot.colors.value(Color::NOTES);
+    out << snapshot.colors.value(Color::WIP);
+    out << snapshot.linkWidth;
+    out << snapshot.padSize;
 }
 
-void SceneLoaderBinary::readConfigFromBinary(QDataStream &in)
+void SceneLoaderBinary::readConfigFromBinary(QDataStream &in, SceneSnapshot &snapshot)
 {
     // Читаем данные конфигурации
-    Config::instance()->readConfigFromBinary(in);
+    in >> snapshot.colors[Color::FRONT] >> snapshot.colors[Color::BACK] >> snapshot.colors[Color::HIGHLIGHTED]
+        >> snapshot.colors[Color::NODE] >> snapshot.colors[Color::NOTES] >> snapshot.colors[Color::WIP]
+        >> snapshot.linkWidth >> snapshot.padSize;
 }
 
-void SceneLoaderBinary::readNodeFromBinary(QDataStream &in, QMap<int, Node *> &nodeMap)
+void SceneLoaderBinary::readNodeFromBinary(QDataStream &in, SceneSnapshot &snapshot)
 {
     // Читаем данные узла
     int id;
     qreal x, y;
     in >> id >> x >> y;
-    qDebug() << "Reading node with ID" << id << "at" << x << "," << y;
+    PCB_TRACE(lcLoad) << "Reading node with ID" << id << "at" << x << "," << y;
 
-    // Создаем новый узел
-    Node *node = new Node(id);
-    node->setPos(x, y);
-    node->setSide(LinkSide::NODE); // Это добавляет его на сцену
-    nodeMap[id] = node;
+    snapshot.nodes.push_back({id, x, y});
 }
 
-Pad *SceneLoaderBinary::readPadFromBinary(QDataStream &in)
+PadRecord SceneLoaderBinary::readPadFromBinary(QDataStream &in)
 {
     // Читаем данные контакта
     int id, number;
     qreal x, y;
     QString name;
     in >> id >> x >> y >> number >> name;
-    qDebug() << "Reading pad with ID" << id << "name" << name << "at" << x << "," << y << "number" << number;
+    PCB_TRACE(lcLoad) << "Reading pad with ID" << id << "name" << name << "at" << x << "," << y << "number" << number;
 
-    // Создаем новый контакт
-    Pad *pad = new Pad(name, id, QPointF(x, y), number);
-    return pad;
+    return {id, x, y, number, name};
 }
 
-void SceneLoaderBinary::readComponentFromBinary(QDataStream &in, QMap<int, Node *> &nodeMap)
+void SceneLoaderBinary::readComponentFromBinary(QDataStream &in, SceneSnapshot &snapshot)
 {
     // Читаем данные компонента
-    int id;
-    QString name;
-    qreal x, y;
-    in >> id >> name >> x >> y;
-
-    // Создаем новый компонент
-    Component *component = new Component(name, id);
-    component->setPos(x, y);
+    ComponentRecord component;
+    in >> component.id >> component.name >> component.x >> component.y;
 
     // Читаем контакты компонента
     quint32 padCount;
     in >> padCount;
-    for (quint32 i = 0; i < padCount; ++i)
+    for (quint32 i = 0; i < padCount && in.status() == QDataStream::Ok; ++i)
     {
-        Pad *pad = readPadFromBinary(in);
-        component->addPad(pad);
-        nodeMap[pad->m_id] = pad;
+        component.pads.push_back(readPadFromBinary(in));
     }
 
-    // Добавляем компонент на сцену
-    component->addToScene(Editor::instance()->scene());
-    CommunicationHub::instance().publish(HubEvent::COMPONENT_CREATED, component);
+    snapshot.components.push_back(std::move(component));
 }
 
-void SceneLoaderBinary::readLinkFromBinary(QDataStream &in, const QMap<int, Node *> &nodeMap)
+void SceneLoaderBinary::readLinkFromBinary(QDataStream &in, SceneSnapshot &snapshot)
 {
     // Читаем данные связи
     int id, fromNodeId, toNodeId, graphId;
@@ -365,44 +789,29 @@ void SceneLoaderBinary::readLinkFromBinary(QDataStream &in, const QMap<int, Node
         in >> width;
     }
 
-    qDebug() << "Reading link with ID" << id << "from node" << fromNodeId << "to node" << toNodeId << "with width" << width;
-
-    // Получаем узлы по их ID
-    Node *fromNode = nodeMap.value(fromNodeId);
-    Node *toNode = nodeMap.value(toNodeId);
+    PCB_TRACE(lcLoad) << "Reading link with ID" << id << "from node" << fromNodeId << "to node" << toNodeId << "with width" << width;
 
-    // Создаем связь если оба узла найдены
-    if (fromNode && toNode)
-    {
-        Link *link = new Link(id);
-        link->setFromNode(fromNode);
-        link->setToNode(toNode);
-        link->setGraphId(graphId);
-        if (hasWidth)
-            link->m_width = width;
-        link->setSide(static_cast<LinkSide>(side));
-        link->refresh();
-    }
-    else
+    std::optional<int> linkWidth;
+    if (hasWidth)
     {
-        qDebug() << "Failed to create link: node not found";
+        linkWidth = static_cast<int>(width);
     }
+    snapshot.links.push_back({id, fromNodeId, toNodeId, graphId, static_cast<LinkSide>(side), linkWidth});
 }
 
-void SceneLoaderBinary::readImageLayerFromBinary(QDataStream &in)
+void SceneLoaderBinary::readImageLayerFromBinary(QDataStream &in, SceneSnapshot &snapshot)
 {
     // Читаем данные слоя изображения
     qint32 id;
     QString imagePath;
     qreal x, y, opacity;
     in >> id >> imagePath >> x >> y >> opacity;
-    qDebug() << "Reading image layer with ID" << id << "at" << x << "," << y << "opacity" << opacity << "image path" << imagePath;
+    PCB_TRACE(lcLoad) << "Reading image layer with ID" << id << "at" << x << "," << y << "opacity" << opacity << "image path" << imagePath;
 
-    // Устанавливаем слой изображения в редакторе
-    Editor::instance()->m_guideTool->setImageLayer(static_cast<LinkSide>(id), imagePath);
+    snapshot.imageLayers.push_back({id, imagePath, x, y, opacity});
 }
 
-void SceneLoaderBinary::readTextNoteFromBinary(QDataStream &in)
+void SceneLoaderBinary::readTextNoteFromBinary(QDataStream &in, SceneSnapshot &snapshot)
 {
     // Читаем данные текстовой заметки
     int id;
@@ -411,29 +820,13 @@ void SceneLoaderBinary::readTextNoteFromBinary(QDataStream &in)
 
     in >> id >> x >> y >> width >> height >> text;
 
-    qDebug() << "Reading TextNote with ID" << id << "at" << x << "," << y << "with size" << width << "x" << height;
-
-    // Создаем новую текстовую заметку
-    QRectF rect(x, y, width, height);
-    TextNote *textNote = new TextNote(rect, Config::instance()->color(Color::NOTES));
-    textNote->m_id = id;
-    textNote->setText(text);
-
-    // Добавляем заметку на сцену
-    Editor::instance()->scene()->addItem(textNote);
-    textNote->setParentItem(Editor::instance()->m_layers[LinkSide::NOTES]);
+    PCB_TRACE(lcLoad) << "Reading TextNote with ID" << id << "at" << x << "," << y << "with size" << width << "x" << height;
 
-    // Уведомляем о создании заметки
-    CommunicationHub::instance().publish(HubEvent::NOTE_CREATED, textNote);
+    snapshot.notes.push_back({id, QRectF(x, y, width, height), text});
 }
 
-void SceneLoaderBinary::readLastIds(QDataStream &in)
+void SceneLoaderBinary::readLastIds(QDataStream &in, SceneSnapshot &snapshot)
 {
     // Читаем последние ID
-    int component, link, note, node;
-    in >> component >> link >> note >> node;
-    Component::setComponentCount(component);
-    Link::setLinkCount(link);
-    NotesTool::setNoteCount(note);
-    Node::setNodeCount(node);
+    in >> snapshot.lastComponentId >> snapshot.lastLinkId >> snapshot.lastNoteId >> snapshot.lastNodeId;
 }
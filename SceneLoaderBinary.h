@@ -5,14 +5,13 @@
 #include <QJsonObject>
 #include <QDataStream>
 #include <QMap>
+#include <functional>
 
 // Предварительные объявления классов
-class Component;
-class Link;
-class Node;
-class Pad;
-class ImageLayer;
-class TextNote;
+class QFile;
+class QFileDevice;
+struct SceneSnapshot;
+struct PadRecord;
 
 /**
  * @brief Перечисление типов элементов сцены для бинарного формата
@@ -29,11 +28,40 @@ enum class SceneElementType : quint8
     Config = 8      ///< Конфигурация
 };
 
+/**
+ * @brief Перечисление секций бинарного формата версии 2
+ */
+enum class SceneSectionType : quint32
+{
+    Meta = 1,        ///< Последние ID и конфигурация (QDataStream, как в версии 1)
+    Strings = 2,     ///< Таблица строк UTF-8
+    Nodes = 3,       ///< Узлы
+    Components = 4,  ///< Компоненты
+    Pads = 5,        ///< Контакты компонентов
+    Links = 6,       ///< Связи
+    ImageLayers = 7, ///< Слои изображений
+    TextNotes = 8    ///< Текстовые заметки
+};
+
 /**
  * @brief Класс бинарного загрузчика сцены
  *
  * SceneLoaderBinary предоставляет статические методы для загрузки и сохранения
  * сцены в бинарном формате (.pcb).
+ *
+ * Версия 1 - последовательность записей QDataStream, каждая с префиксом SceneElementType.
+ * Читается для совместимости, новые файлы сохраняются в версии 2; запись версии 1
+ * оставлена для сравнения форматов в бенчмарках.
+ *
+ * Версия 2 загружается через QFile::map без построчной десериализации:
+ * - заголовок (16 байт): "PCBTRC", версия (qint32 big-endian, как в версии 1),
+ *   резерв (2 байта), число секций (quint32);
+ * - таблица секций: для каждой секции тип, число элементов (quint32),
+ *   смещение и размер в байтах (quint64);
+ * - секции, выровненные на 8 байт. Элементы хранятся по столбцам фиксированной ширины
+ *   (struct-of-arrays), каждый столбец выровнен на 8 байт от начала секции;
+ *   строки хранятся в секции Strings и задаются парой столбцов (смещение, длина).
+ * Все числа после версии записаны в little-endian.
  */
 class SceneLoaderBinary
 {
@@ -52,112 +80,140 @@ public:
      */
     static bool saveSceneToBinary(const QString &filename);
 
-private:
     /**
-     * @brief Записывает компонент в бинарный поток
-     * @param out Бинарный поток для записи
-     * @param component Указатель на компонент
+     * @brief Разбирает бинарный файл сцены в снимок
+     *
+     * Не обращается к графическим элементам, поэтому может вызываться из рабочего потока.
+     * Элементы создаются затем вызовом SceneSnapshot::restore() в GUI-потоке.
+     * @param filename Путь к файлу сцены
+     * @param snapshot Снимок, в который добавляются элементы
+     * @param error Описание ошибки, если разбор не удался
+     * @param progress Вызывается с процентом выполнения, возврат false прерывает разбор
+     * @return true если разбор успешен, false в противном случае
      */
-    static void writeComponentToBinary(QDataStream &out, Component *component);
+    static bool decodeBinary(const QString &filename, SceneSnapshot &snapshot, QString &error,
+                             const std::function<bool(int)> &progress = {});
 
     /**
-     * @brief Записывает контакт в бинарный поток
-     * @param out Бинарный поток для записи
-     * @param pad Указатель на контакт
+     * @brief Сохраняет снимок сцены в бинарный файл
+     *
+     * Не обращается к графическим элементам, поэтому может вызываться из рабочего потока.
+     * Файл записывается через QSaveFile и заменяется только после успешной записи.
+     * @param snapshot Снимок сцены
+     * @param filename Путь к файлу для сохранения
+     * @param version Версия формата (1 или 2)
+     * @return true если сохранение успешно, false в противном случае
      */
-    static void writePadToBinary(QDataStream &out, Pad *pad);
+    static bool saveSnapshotToBinary(const SceneSnapshot &snapshot, const QString &filename, qint32 version = 2);
 
+private:
     /**
-     * @brief Записывает связь в бинарный поток
-     * @param out Бинарный поток для записи
-     * @param link Указатель на связь
+     * @brief Читает элементы сцены в формате версии 1
+     * @param file Файл, позиционированный после заголовка
+     * @param snapshot Снимок, в который добавляются элементы
+     * @param error Описание ошибки
+     * @param progress Функция прогресса
+     * @return true если чтение успешно, false в противном случае
      */
-    static void writeLinkToBinary(QDataStream &out, Link *link);
+    static bool readVersion1(QFile &file, SceneSnapshot &snapshot, QString &error,
+                             const std::function<bool(int)> &progress);
 
     /**
-     * @brief Записывает узел в бинарный поток
-     * @param out Бинарный поток для записи
-     * @param node Указатель на узел
+     * @brief Читает элементы сцены в формате версии 2 через отображение файла в память
+     * @param file Открытый файл сцены
+     * @param snapshot Снимок, в который добавляются элементы
+     * @param error Описание ошибки
+     * @param progress Функция прогресса
+     * @return true если чтение успешно, false в противном случае
      */
-    static void writeNodeToBinary(QDataStream &out, Node *node);
+    static bool readVersion2(QFile &file, SceneSnapshot &snapshot, QString &error,
+                             const std::function<bool(int)> &progress);
 
     /**
-     * @brief Записывает текстовую заметку в бинарный поток
-     * @param out Бинарный поток для записи
-     * @param textNote Указатель на текстовую заметку
+     * @brief Записывает снимок в формате версии 1 (поток записей QDataStream)
+     * @param file Открытый файл
+     * @param snapshot Снимок сцены
+     * @return true если запись успешна, false в противном случае
      */
-    static void writeTextNoteToBinary(QDataStream &out, TextNote *textNote);
+    static bool writeVersion1(QFileDevice &file, const SceneSnapshot &snapshot);
 
     /**
-     * @brief Записывает слой изображения в бинарный поток
-     * @param out Бинарный поток для записи
-     * @param imageLayer Указатель на слой изображения
+     * @brief Записывает снимок в формате версии 2 (секции по столбцам)
+     * @param file Открытый файл, заголовок записывается в конце через seek
+     * @param snapshot Снимок сцены
+     * @return true если запись успешна, false в противном случае
      */
-    static void writeImageLayerToBinary(QDataStream &out, ImageLayer *imageLayer);
+    static bool writeVersion2(QFileDevice &file, const SceneSnapshot &snapshot);
 
     /**
      * @brief Записывает последние ID в бинарный поток
      * @param out Бинарный поток для записи
+     * @param snapshot Снимок сцены
      */
-    static void writeLastIds(QDataStream &out);
+    static void writeLastIds(QDataStream &out, const SceneSnapshot &snapshot);
 
     /**
      * @brief Записывает конфигурацию в бинарный поток
      * @param out Бинарный поток для записи
+     * @param snapshot Снимок сцены
      */
-    static void writeConfigToBinary(QDataStream &out);
+    static void writeConfigToBinary(QDataStream &out, const SceneSnapshot &snapshot);
 
     /**
      * @brief Читает конфигурацию из бинарного потока
      * @param in Бинарный поток для чтения
+     * @param snapshot Снимок сцены
      */
-    static void readConfigFromBinary(QDataStream &in);
+    static void readConfigFromBinary(QDataStream &in, SceneSnapshot &snapshot);
 
     /**
      * @brief Читает компонент из бинарного потока
      * @param in Бинарный поток для чтения
-     * @param nodeMap Словарь узлов
+     * @param snapshot Снимок сцены
      */
-    static void readComponentFromBinary(QDataStream &in, QMap<int, Node *> &nodeMap);
+    static void readComponentFromBinary(QDataStream &in, SceneSnapshot &snapshot);
 
     /**
      * @brief Читает контакт из бинарного потока
      * @param in Бинарный поток для чтения
-     * @return Указатель на созданный контакт
+     * @return Данные контакта
      */
-    static Pad *readPadFromBinary(QDataStream &in);
+    static PadRecord readPadFromBinary(QDataStream &in);
 
     /**
      * @brief Читает связь из бинарного потока
      * @param in Бинарный поток для чтения
-     * @param nodeMap Словарь узлов
+     * @param snapshot Снимок сцены
      */
-    static void readLinkFromBinary(QDataStream &in, const QMap<int, Node *> &nodeMap);
+    static void readLinkFromBinary(QDataStream &in, SceneSnapshot &snapshot);
 
     /**
      * @brief Читает узел из бинарного потока
      * @param in Бинарный поток для чтения
-     * @param nodeMap Словарь узлов
+     * @param snapshot Снимок сцены
      */
-    static void readNodeFromBinary(QDataStream &in, QMap<int, Node *> &nodeMap);
+    static void readNodeFromBinary(QDataStream &in, SceneSnapshot &snapshot);
 
     /**
      * @brief Читает слой изображения из бинарного потока
      * @param in Бинарный поток для чтения
+     * @param snapshot Снимок сцены
      */
-    static void readImageLayerFromBinary(QDataStream &in);
+    static void readImageLayerFromBinary(QDataStream &in, SceneSnapshot &snapshot);
 
     /**
      * @brief Читает текстовую заметку из бинарного потока
      * @param in Бинарный поток для чтения
+     * @param snapshot Снимок сцены
      */
-    static void readTextNoteFromBinary(QDataStream &in);
+    static void readTextNoteFromBinary(QDataStream &in, SceneSnapshot &snapshot);
 
     /**
      * @brief Читает последние ID из бинарного потока
      * @param in Бинарный поток для чтения
+     * @param snapshot Снимок сцены
      */
-    static void readLastIds(QDataStream &in);
+    static void readLastIds(QDataStream &in, SceneSnapshot &snapshot);
 
     /**
      * @brief Конструктор бинарного загрузчика сцены
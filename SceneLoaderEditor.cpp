@@ -0,0 +1,71 @@
+#include "SceneLoader.h"
+#include "SceneLoaderBinary.h"
+#include "SceneSnapshot.h"
+#include "Editor.h"
+#include "Trace.h"
+#include <QMessageBox>
+#include <QElapsedTimer>
+#include <QDebug>
+
+/*
+ * Точки входа загрузчиков, работающие со сценой редактора.
+ * Разбор и запись файлов (SceneLoader.cpp, SceneLoaderBinary.cpp) от редактора
+ * не зависят и собираются также в pcb-tracer-cli.
+ */
+
+bool SceneLoader::loadSceneFromJson(const QString &filename)
+{
+    Editor *editor = Editor::instance();
+    editor->showStatusMessage(QString("Loading %1").arg(filename));
+    qDebug() << "Loading" << filename;
+
+    // Разбираем файл в снимок и создаем элементы сцены
+    SceneSnapshot snapshot;
+    QString error;
+    if (!decodeJson(filename, snapshot, error))
+    {
+        qDebug() << "An error occurred while loading the scene:" << error;
+        QMessageBox::critical(nullptr, "Error", QString("An error occurred while loading the scene: %1").arg(error));
+        return false;
+    }
+    snapshot.restore();
+
+    editor->showStatusMessage("Scene loaded successfully");
+    qDebug() << "Scene loaded from" << filename;
+    return true;
+}
+
+QJsonObject SceneLoader::getSceneElements()
+{
+    return snapshotToJson(SceneSnapshot::capture());
+}
+
+bool SceneLoader::saveSceneToJson(const QString &filename)
+{
+    return saveSnapshotToJson(SceneSnapshot::capture(), filename);
+}
+
+bool SceneLoaderBinary::loadSceneFromBinary(const QString &filename)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    // Разбираем файл в снимок и создаем элементы сцены
+    SceneSnapshot snapshot;
+    QString error;
+    if (!decodeBinary(filename, snapshot, error))
+    {
+        qDebug() << "Failed to load" << filename << ":" << error;
+        return false;
+    }
+    snapshot.restore();
+
+    qCDebug(lcLoad) << "Scene loaded from" << filename << "in" << timer.elapsed() << "ms";
+    Editor::instance()->showStatusMessage("Scene loaded successfully");
+    return true;
+}
+
+bool SceneLoaderBinary::saveSceneToBinary(const QString &filename)
+{
+    return saveSnapshotToBinary(SceneSnapshot::capture(), filename);
+}
@@ -0,0 +1,280 @@
+#include "SceneSnapshot.h"
+#include "ItemRegistry.h"
+#include "TrackGraph.h"
+#include "Config.h"
+#include "Component.h"
+#include "Link.h"
+#include "Node.h"
+#include "ImageLayer.h"
+#include "NotesTool.h"
+#include "Editor.h"
+#include <QScopeGuard>
+#include "CommunicationHub.h"
+#include <unordered_map>
+#include <algorithm>
+
+namespace
+{
+/// Число элементов между вызовами функции прогресса
+constexpr size_t ProgressStep = 1024;
+}
+
+SceneSnapshot SceneSnapshot::capture()
+{
+    SceneSnapshot snapshot;
+    ItemRegistry &registry = ItemRegistry::instance();
+
+    // Последние ID
+    snapshot.lastComponentId = Component::getLastComponentId();
+    snapshot.lastLinkId = Link::getLastLinkId();
+    snapshot.lastNoteId = NotesTool::getLastNoteId();
+    snapshot.lastNodeId = Node::getLastNodeId();
+
+    // Конфигурация
+    Config *config = Config::instance();
+    for (Color color : {Color::FRONT, Color::BACK, Color::WIP, Color::NOTES, Color::NODE, Color::HIGHLIGHTED})
+    {
+        snapshot.colors[color] = config->color(color);
+    }
+    snapshot.linkWidth = config->m_linkWidth;
+    snapshot.trackGraphCount = TrackGraph::count;
+    snapshot.padSize = config->m_padSize;
+
+    // Узлы (контакты сохраняются вместе с компонентами)
+    snapshot.nodes.reserve(registry.all<Node>().size());
+    for (const auto &[id, node] : registry.all<Node>())
+    {
+        if (id >= 0 && node->scene() && registry.all<Pad>().count(id) == 0)
+        {
+            snapshot.nodes.push_back({id, node->pos().x(), node->pos().y()});
+        }
+    }
+
+    // Компоненты с контактами
+    for (const auto &[id, component] : registry.all<Component>())
+    {
+        if (!component->scene())
+        {
+            continue;
+        }
+        ComponentRecord record{component->m_id, component->m_name, component->pos().x(), component->pos().y(), {}};
+        record.pads.reserve(component->m_pads.size());
+        for (const Pad *pad : component->m_pads)
+        {
+            record.pads.push_back({pad->m_id, pad->pos().x(), pad->pos().y(), pad->m_number, pad->m_name});
+        }
+        snapshot.components.push_back(std::move(record));
+    }
+
+    // Связи по цепям
+    size_t linkCount = 0;
+    for (const auto &[graphId, net] : TrackGraph::nets())
+    {
+        linkCount += net.links.size();
+    }
+    snapshot.links.reserve(linkCount);
+    for (const auto &[graphId, net] : TrackGraph::nets())
+    {
+        for (const Link *link : net.links)
+        {
+            if (!link->fromNode() || !link->toNode())
+            {
+                continue; // связь еще не подключена к узлам
+            }
+            snapshot.links.push_back({link->m_id, link->fromNode()->m_id, link->toNode()->m_id,
+                                      link->m_graphId, link->m_side, link->m_width});
+        }
+    }
+
+    // Слои изображений
+    for (const auto &[id, imageLayer] : registry.all<ImageLayer>())
+    {
+        if (imageLayer->scene())
+        {
+            snapshot.imageLayers.push_back({imageLayer->m_id, imageLayer->m_imagePath,
+                                            imageLayer->pos().x(), imageLayer->pos().y(), imageLayer->opacity()});
+        }
+    }
+
+    // Текстовые заметки
+    for (const auto &[id, textNote] : registry.all<TextNote>())
+    {
+        if (textNote->scene())
+        {
+            snapshot.notes.push_back({textNote->m_id, textNote->rect(), textNote->m_text});
+        }
+    }
+
+    // Реестр и цепи хранятся в хеш-таблицах, порядок обхода зависит от адресов элементов.
+    // Сортировка по ID делает сохранение одной и той же платы побайтно одинаковым.
+    auto byId = [](const auto &a, const auto &b)
+    { return a.id < b.id; };
+    std::sort(snapshot.nodes.begin(), snapshot.nodes.end(), byId);
+    std::sort(snapshot.components.begin(), snapshot.components.end(), byId);
+    std::sort(snapshot.links.begin(), snapshot.links.end(), byId);
+    std::sort(snapshot.imageLayers.begin(), snapshot.imageLayers.end(), byId);
+    std::sort(snapshot.notes.begin(), snapshot.notes.end(), byId);
+
+    return snapshot;
+}
+
+size_t SceneSnapshot::elementCount() const
+{
+    size_t count = nodes.size() + links.size() + imageLayers.size() + notes.size();
+    for (const ComponentRecord &component : components)
+    {
+        count += 1 + component.pads.size();
+    }
+    return count;
+}
+
+bool SceneSnapshot::restore(const std::function<bool(int)> &progress) const
+{
+    // Индекс сцены отключается на время массового добавления и перестраивается один раз в конце
+    QGraphicsScene *scene = Editor::instance()->scene();
+    QGraphicsScene::ItemIndexMethod indexMethod = scene->itemIndexMethod();
+    scene->setItemIndexMethod(QGraphicsScene::NoIndex);
+    bool completed = restoreItems(progress);
+    scene->setItemIndexMethod(indexMethod);
+    return completed;
+}
+
+bool SceneSnapshot::restoreItems(const std::function<bool(int)> &progress) const
+{
+    Editor *editor = Editor::instance();
+
+    // Счетчики ID
+    if (lastComponentId >= 0)
+        Component::setComponentCount(lastComponentId);
+    if (lastLinkId >= 0)
+        Link::setLinkCount(lastLinkId);
+    if (lastNoteId >= 0)
+        NotesTool::setNoteCount(lastNoteId);
+    if (lastNodeId >= 0)
+        Node::setNodeCount(lastNodeId);
+    if (trackGraphCount >= 0)
+        TrackGraph::setTrackGraphCount(trackGraphCount);
+
+    // Конфигурация
+    if (!colors.isEmpty())
+    {
+        Config *config = Config::instance();
+        for (auto it = colors.begin(); it != colors.end(); ++it)
+        {
+            config->setColor(it.key(), it.value());
+        }
+        config->m_linkWidth = linkWidth;
+        config->m_padSize = padSize;
+    }
+
+    // Прогресс сообщается раз в ProgressStep элементов
+    const size_t total = std::max<size_t>(elementCount(), 1);
+    size_t done = 0;
+    auto step = [&]()
+    {
+        return ++done % ProgressStep != 0 || !progress || progress(int(done * 100 / total));
+    };
+
+    // Вид узлов не обновляется после каждой связи
+    Node::setRefreshDeferred(true);
+    auto refreshGuard = qScopeGuard([]
+                                    { Node::setRefreshDeferred(false); });
+
+    std::unordered_map<int, Node *> nodeMap;
+    nodeMap.reserve(total);
+    std::vector<Node *> plainNodes;
+    plainNodes.reserve(nodes.size());
+
+    // Узлы
+    for (const NodeRecord &record : nodes)
+    {
+        Node *node = new Node(record.id);
+        node->setPos(record.x, record.y);
+        node->setSide(LinkSide::NODE); // Это добавляет его на сцену
+        nodeMap[record.id] = node;
+        plainNodes.push_back(node);
+        if (!step())
+            return false;
+    }
+
+    // Компоненты с контактами
+    for (const ComponentRecord &record : components)
+    {
+        Component *component = new Component(record.name, record.id);
+        component->setPos(record.x, record.y);
+        for (const PadRecord &padRecord : record.pads)
+        {
+            Pad *pad = new Pad(padRecord.name, padRecord.id, QPointF(padRecord.x, padRecord.y), padRecord.number);
+            component->addPad(pad);
+            nodeMap[pad->m_id] = pad;
+            ++done;
+        }
+        component->addToScene(editor->scene());
+        CommunicationHub::instance().publish(HubEvent::COMPONENT_CREATED, component);
+        if (!step())
+            return false;
+    }
+
+    // Связи
+    for (const LinkRecord &record : links)
+    {
+        auto fromNode = nodeMap.find(record.fromNodeId);
+        auto toNode = nodeMap.find(record.toNodeId);
+
+        // Создаем связь если оба узла найдены
+        if (fromNode != nodeMap.end() && toNode != nodeMap.end())
+        {
+            Link *link = new Link(record.id);
+            link->setFromNode(fromNode->second);
+            link->setToNode(toNode->second);
+            link->setGraphId(record.graphId);
+            link->m_width = record.width;
+            link->setSide(record.side); // Также задает цвет связи
+        }
+        else
+        {
+            qDebug() << "Failed to create link" << record.id << ": node not found";
+        }
+        if (!step())
+            return false;
+    }
+
+    // Вид узлов обновляется один раз после добавления всех связей,
+    // уведомляем об изменениях связей для узлов (контакты обрабатывают их сами)
+    for (Node *node : plainNodes)
+    {
+        node->refresh();
+        node->notifyLinkChanges();
+    }
+
+    // Слои изображений
+    for (const ImageLayerRecord &record : imageLayers)
+    {
+        editor->m_guideTool->setImageLayer(static_cast<LinkSide>(record.id), record.imagePath);
+        if (!step())
+            return false;
+    }
+
+    // Текстовые заметки
+    for (const TextNoteRecord &record : notes)
+    {
+        TextNote *textNote = new TextNote(record.rect, Config::instance()->color(Color::NOTES));
+        textNote->setId(record.id >= 0 ? record.id : NotesTool::genNoteId());
+        textNote->setText(record.text);
+
+        // Добавляем заметку на сцену
+        editor->scene()->addItem(textNote);
+        textNote->setParentItem(editor->m_layers[LinkSide::NOTES]);
+
+        // Уведомляем о создании заметки
+        CommunicationHub::instance().publish(HubEvent::NOTE_CREATED, textNote);
+        if (!step())
+            return false;
+    }
+
+    if (progress)
+    {
+        progress(100);
+    }
+    return true;
+}
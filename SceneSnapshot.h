@@ -0,0 +1,136 @@
+#ifndef SCENESNAPSHOT_H
+#define SCENESNAPSHOT_H
+
+#include <QString>
+#include <QDebug>
+#include <QRectF>
+#include <QMap>
+#include <optional>
+#include <vector>
+#include <functional>
+#include "enums.h"
+
+/**
+ * @brief Данные узла (не контакта)
+ */
+struct NodeRecord
+{
+    int id;   ///< Идентификатор узла
+    qreal x;  ///< Координата X
+    qreal y;  ///< Координата Y
+};
+
+/**
+ * @brief Данные контакта компонента
+ */
+struct PadRecord
+{
+    int id;       ///< Идентификатор контакта
+    qreal x;      ///< Координата X
+    qreal y;      ///< Координата Y
+    int number;   ///< Номер контакта в компоненте
+    QString name; ///< Имя контакта
+};
+
+/**
+ * @brief Данные компонента вместе с его контактами
+ */
+struct ComponentRecord
+{
+    int id;                      ///< Идентификатор компонента
+    QString name;                ///< Имя компонента
+    qreal x;                     ///< Координата X
+    qreal y;                     ///< Координата Y
+    std::vector<PadRecord> pads; ///< Контакты компонента
+};
+
+/**
+ * @brief Данные связи
+ */
+struct LinkRecord
+{
+    int id;                    ///< Идентификатор связи
+    int fromNodeId;            ///< Идентификатор начального узла
+    int toNodeId;              ///< Идентификатор конечного узла
+    int graphId;               ///< Идентификатор графа (цепи)
+    LinkSide side;             ///< Сторона платы
+    std::optional<int> width;  ///< Ширина связи (если задана)
+};
+
+/**
+ * @brief Данные слоя изображения
+ */
+struct ImageLayerRecord
+{
+    int id;            ///< Идентификатор слоя (сторона платы)
+    QString imagePath; ///< Путь к файлу изображения
+    qreal x;           ///< Координата X
+    qreal y;           ///< Координата Y
+    qreal opacity;     ///< Прозрачность слоя
+};
+
+/**
+ * @brief Данные текстовой заметки
+ */
+struct TextNoteRecord
+{
+    int id;       ///< Идентификатор заметки
+    QRectF rect;  ///< Прямоугольник заметки
+    QString text; ///< Текст заметки
+};
+
+/**
+ * @brief Неизменяемый снимок сцены из простых данных
+ *
+ * SceneSnapshot снимается в GUI-потоке и не ссылается на графические элементы,
+ * поэтому его можно сериализовать в рабочем потоке, пока редактор продолжает работу.
+ */
+struct SceneSnapshot
+{
+    std::vector<NodeRecord> nodes;             ///< Узлы (без контактов)
+    std::vector<ComponentRecord> components;   ///< Компоненты с контактами
+    std::vector<LinkRecord> links;             ///< Связи
+    std::vector<ImageLayerRecord> imageLayers; ///< Слои изображений
+    std::vector<TextNoteRecord> notes;         ///< Текстовые заметки
+
+    // Счетчики ID (-1 - не менять при восстановлении)
+    int lastComponentId = -1; ///< Последний ID компонента
+    int lastLinkId = -1;      ///< Последний ID связи
+    int lastNoteId = -1;      ///< Последний ID заметки
+    int lastNodeId = -1;      ///< Последний ID узла
+    int trackGraphCount = -1; ///< Счетчик графов трассировки
+
+    QMap<Color, QString> colors; ///< Цвета конфигурации (пусто - конфигурация не меняется)
+    int linkWidth = 0;           ///< Ширина связей из конфигурации
+    int padSize = 0;             ///< Размер контактов из конфигурации
+
+    /**
+     * @brief Снимает снимок текущей сцены
+     *
+     * Должен вызываться из GUI-потока.
+     * @return Снимок сцены
+     */
+    static SceneSnapshot capture();
+
+    /**
+     * @brief Создает элементы снимка на сцене редактора
+     *
+     * Должен вызываться из GUI-потока на очищенной сцене. Индекс сцены отключается
+     * на время добавления элементов и перестраивается один раз в конце.
+     * Заметки с ID -1 получают новый ID.
+     * @param progress Вызывается с процентом выполнения, возврат false прерывает восстановление
+     * @return false если восстановление прервано (сцена заполнена частично)
+     */
+    bool restore(const std::function<bool(int)> &progress = {}) const;
+
+    /**
+     * @brief Общее число элементов снимка (для отображения прогресса)
+     * @return Число узлов, контактов, компонентов, связей, слоев и заметок
+     */
+    size_t elementCount() const;
+
+private:
+    bool restoreItems(const std::function<bool(int)> &progress) const;
+};
+
+#endif // SCENESNAPSHOT_H
@@ -0,0 +1,168 @@
+#include "SceneValidator.h"
+#include "SceneSnapshot.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace
+{
+/*
+ * Функция findRoot - корень множества в системе непересекающихся множеств
+ * Входные параметры:
+ *   parent - массив родителей
+ *   index - элемент
+ * Выходные данные:
+ *   size_t - корень множества элемента
+ */
+size_t findRoot(std::vector<size_t> &parent, size_t index)
+{
+    while (parent[index] != index)
+    {
+        parent[index] = parent[parent[index]];
+        index = parent[index];
+    }
+    return index;
+}
+
+/*
+ * Функция unite - объединение множеств двух элементов
+ * Входные параметры:
+ *   parent - массив родителей
+ *   a, b - элементы
+ * Выходные данные:
+ *   отсутствуют
+ */
+void unite(std::vector<size_t> &parent, size_t a, size_t b)
+{
+    a = findRoot(parent, a);
+    b = findRoot(parent, b);
+    if (a != b)
+    {
+        parent[std::max(a, b)] = std::min(a, b);
+    }
+}
+}
+
+/*
+ * Функция SceneValidator::validate - проверка целостности снимка сцены
+ * Входные параметры:
+ *   snapshot - снимок сцены
+ * Выходные данные:
+ *   QStringList - описания найденных проблем
+ */
+QStringList SceneValidator::validate(const SceneSnapshot &snapshot)
+{
+    QStringList issues;
+
+    // Узлы и контакты получают ID из общего счетчика, поэтому индексируются вместе
+    std::unordered_map<int, size_t> nodeRows;
+    nodeRows.reserve(snapshot.nodes.size());
+    for (const NodeRecord &node : snapshot.nodes)
+    {
+        if (!nodeRows.emplace(node.id, nodeRows.size()).second)
+        {
+            issues << QString("Duplicate node id %1").arg(node.id);
+        }
+    }
+    std::unordered_set<int> componentIds;
+    for (const ComponentRecord &component : snapshot.components)
+    {
+        if (!componentIds.insert(component.id).second)
+        {
+            issues << QString("Duplicate component id %1 (%2)").arg(component.id).arg(component.name);
+        }
+        for (const PadRecord &pad : component.pads)
+        {
+            if (!nodeRows.emplace(pad.id, nodeRows.size()).second)
+            {
+                issues << QString("Duplicate pad id %1 in component %2 (%3)").arg(pad.id).arg(component.id).arg(component.name);
+            }
+        }
+    }
+
+    // Связи с известными узлами: строки концов для проверки цепей
+    struct Endpoints
+    {
+        size_t from;
+        size_t to;
+        int graphId;
+    };
+    std::vector<Endpoints> links;
+    links.reserve(snapshot.links.size());
+    std::unordered_set<int> linkIds;
+    linkIds.reserve(snapshot.links.size());
+    for (const LinkRecord &link : snapshot.links)
+    {
+        if (!linkIds.insert(link.id).second)
+        {
+            issues << QString("Duplicate link id %1").arg(link.id);
+        }
+        auto from = nodeRows.find(link.fromNodeId);
+        auto to = nodeRows.find(link.toNodeId);
+        if (from == nodeRows.end() || to == nodeRows.end())
+        {
+            issues << QString("Link %1 (%2 -> %3) refers to a missing node").arg(link.id).arg(link.fromNodeId).arg(link.toNodeId);
+            continue;
+        }
+        if (link.fromNodeId == link.toNodeId)
+        {
+            issues << QString("Link %1 starts and ends at node %2").arg(link.id).arg(link.fromNodeId);
+        }
+        links.push_back({from->second, to->second, link.graphId});
+    }
+
+    // Все связи узла должны принадлежать одной цепи; о каждом узле сообщается один раз
+    const size_t nodeCount = nodeRows.size();
+    std::vector<int> nodeNet(nodeCount);
+    std::vector<char> seen(nodeCount, 0); // 0 - нет связей, 1 - цепь известна, 2 - уже сообщено
+    std::vector<int> rowIds(nodeCount);
+    for (const auto &[id, row] : nodeRows)
+    {
+        rowIds[row] = id;
+    }
+    for (const Endpoints &link : links)
+    {
+        for (size_t row : {link.from, link.to})
+        {
+            if (seen[row] == 0)
+            {
+                seen[row] = 1;
+                nodeNet[row] = link.graphId;
+            }
+            else if (seen[row] == 1 && nodeNet[row] != link.graphId)
+            {
+                seen[row] = 2;
+                issues << QString("Node %1 joins nets %2 and %3").arg(rowIds[row]).arg(nodeNet[row]).arg(link.graphId);
+            }
+        }
+    }
+
+    // Каждая цепь должна быть связной
+    std::vector<size_t> parent(nodeCount);
+    std::iota(parent.begin(), parent.end(), size_t(0));
+    for (const Endpoints &link : links)
+    {
+        unite(parent, link.from, link.to);
+    }
+    std::unordered_map<int, std::unordered_set<size_t>> partsOfNet;
+    for (const Endpoints &link : links)
+    {
+        partsOfNet[link.graphId].insert(findRoot(parent, link.from));
+    }
+    std::vector<int> splitNets;
+    for (const auto &[graphId, parts] : partsOfNet)
+    {
+        if (parts.size() > 1)
+        {
+            splitNets.push_back(graphId);
+        }
+    }
+    std::sort(splitNets.begin(), splitNets.end());
+    for (int graphId : splitNets)
+    {
+        issues << QString("Net %1 is split into %2 parts").arg(graphId).arg(partsOfNet[graphId].size());
+    }
+
+    return issues;
+}
@@ -0,0 +1,28 @@
+#ifndef SCENEVALIDATOR_H
+#define SCENEVALIDATOR_H
+
+#include <QStringList>
+
+struct SceneSnapshot;
+
+/**
+ * @brief Проверка целостности снимка сцены
+ *
+ * Работает только с простыми данными снимка (без сцены, Editor и QApplication),
+ * поэтому файлы можно проверять в рабочих потоках, например в pcb-tracer-cli.
+ *
+ * Находит повторяющиеся ID, связи с отсутствующими узлами, связи-петли,
+ * узлы, соединяющие разные цепи, и цепи, разбитые на несколько частей.
+ */
+class SceneValidator
+{
+public:
+    /**
+     * @brief Проверяет снимок сцены
+     * @param snapshot Снимок (например, из SceneLoader::decodeJson)
+     * @return Список описаний проблем (пустой - снимок целостен)
+     */
+    static QStringList validate(const SceneSnapshot &snapshot);
+};
+
+#endif // SCENEVALIDATOR_H
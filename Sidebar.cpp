@@ -3,6 +3,7 @@
 #include <QListWidgetItem>
 #include "CommunicationHub.h"
 #include "NotesTool.h"
+#include "Trace.h"
 
 Sidebar::Sidebar(QWidget* parent)  {
     setupUi();
@@ -67,7 +68,7 @@ void Sidebar::onListItemDoubleClicked(QListWidgetItem* item) {
         Editor::instance()->centerOn(component->m_pads[0]);
     } else if (data.canConvert<TextNote*>()) {
         TextNote* note = data.value<TextNote*>();
-        qDebug() << "Double-clicked on note";
+        PCB_TRACE(lcTools) << "Double-clicked on note";
         Editor::instance()->centerOn(note);
     }
 }
@@ -141,17 +142,17 @@ void Sidebar::onSceneCleanHandler(void* data, HubEvent action) {
 }
 
 void Sidebar::addComponentToList(Component* component, QListWidget* listWidget) {
-    qDebug() << "Component id:" << component->m_id << "- name:" << component->m_name << "created";
+    PCB_TRACE(lcTools) << "Component id:" << component->m_id << "- name:" << component->m_name << "created";
     auto [existingItem, _] = findItemById(listWidget, component->m_id);
     if (!existingItem) {
-        qDebug() << "Adding it";
+        PCB_TRACE(lcTools) << "Adding it";
         QString item = QString("%1 - %2 pins").arg(component->m_name).arg(component->numberOfPads());
         QListWidgetItem* listItem = new QListWidgetItem(item);
         listItem->setData(Qt::UserRole, QVariant::fromValue(component));
         listWidget->addItem(listItem);
         listWidget->sortItems(Qt::AscendingOrder);
     } else {
-        qDebug() << "Already exists";
+        PCB_TRACE(lcTools) << "Already exists";
     }
 }
 
@@ -159,9 +160,9 @@ void Sidebar::removeComponentFromList(Component* component, QListWidget* listWid
     auto [item, index] = findItemById(listWidget, component->m_id);
     if (item) {
         delete listWidget->takeItem(index);
-        qDebug() << "Removed component from list: Component ID:" << component->m_id;
+        PCB_TRACE(lcTools) << "Removed component from list: Component ID:" << component->m_id;
     } else {
-        qDebug() << "Component ID:" << component->m_id << "not found in list, ignoring deletion";
+        PCB_TRACE(lcTools) << "Component ID:" << component->m_id << "not found in list, ignoring deletion";
     }
 }
 
@@ -169,23 +170,23 @@ void Sidebar::removeNoteFromList(TextNote* note, QListWidget* listWidget) {
     auto [item, index] = findItemById(listWidget, note->m_id);
     if (item) {
         delete listWidget->takeItem(index);
-        qDebug() << "Removed note from list: Note ID:" << note->m_id;
+        PCB_TRACE(lcTools) << "Removed note from list: Note ID:" << note->m_id;
     } else {
-        qDebug() << "Note ID:" << note->m_id << "not found in list, ignoring deletion";
+        PCB_TRACE(lcTools) << "Note ID:" << note->m_id << "not found in list, ignoring deletion";
     }
 }
 
 void Sidebar::addNoteToList(TextNote* note, QListWidget* listWidget) {
-    qDebug() << "Note id:" << note->m_id << "- text:" << note->m_text << "created";
+    PCB_TRACE(lcTools) << "Note id:" << note->m_id << "- text:" << note->m_text << "created";
     auto [existingItem, _] = findItemById(listWidget, note->m_id);
     if (!existingItem) {
-        qDebug() << "Adding it";
+        PCB_TRACE(lcTools) << "Adding it";
         QString item = QString("%1").arg(note->m_text);
         QListWidgetItem* listItem = new QListWidgetItem(item);
         listItem->setData(Qt::UserRole, QVariant::fromValue(note));
         listWidget->addItem(listItem);
         listWidget->sortItems(Qt::AscendingOrder);
     } else {
-        qDebug() << "Already exists";
+        PCB_TRACE(lcTools) << "Already exists";
     }
 }
\ No newline at end of file
@@ -0,0 +1,7 @@
+#include "Trace.h"
+
+// Отладочные сообщения категорий выключены по умолчанию
+Q_LOGGING_CATEGORY(lcLoad, "pcbtracer.load", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcScene, "pcbtracer.scene", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcView, "pcbtracer.view", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcTools, "pcbtracer.tools", QtInfoMsg)
@@ -0,0 +1,32 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <QLoggingCategory>
+
+/*
+ * Категории трассировки
+ *
+ * Поэлементные сообщения (по одному на узел, связь, событие мыши) пишутся через PCB_TRACE.
+ * Без определения PCB_TRACER_TRACE (опция CMake PCB_TRACER_TRACE) они не попадают в сборку.
+ * Когда трассировка собрана, сообщения категорий по умолчанию выключены и включаются
+ * правилами QT_LOGGING_RULES, например: QT_LOGGING_RULES="pcbtracer.load.debug=true".
+ *
+ * 1. lcLoad  - pcbtracer.load  - загрузка и сохранение сцены
+ * 2. lcScene - pcbtracer.scene - изменения элементов сцены
+ * 3. lcView  - pcbtracer.view  - масштабирование и события мыши в окне просмотра
+ * 4. lcTools - pcbtracer.tools - инструменты редактора и боковая панель
+ */
+Q_DECLARE_LOGGING_CATEGORY(lcLoad)
+Q_DECLARE_LOGGING_CATEGORY(lcScene)
+Q_DECLARE_LOGGING_CATEGORY(lcView)
+Q_DECLARE_LOGGING_CATEGORY(lcTools)
+
+#ifdef PCB_TRACER_TRACE
+#define PCB_TRACE(category) qCDebug(category)
+#else
+#define PCB_TRACE(category) \
+    while (false)           \
+    QMessageLogger().noDebug()
+#endif
+
+#endif // TRACE_H
@@ -4,6 +4,8 @@
 #include "actions/AssignSideToTrack.h"
 #include "Component.h"
 #include "TypeChecks.h"
+#include "Trace.h"
+#include "NodeIndex.h"
 
 TrackDrawingTool::TrackDrawingTool(Editor* editor)
     : m_editor(editor),
@@ -18,7 +20,7 @@ TrackDrawingTool::TrackDrawingTool(Editor* editor)
 void TrackDrawingTool::enterMode()
 {
     m_editor->setCursor(Qt::CrossCursor);
-    qDebug() << "Entering track drawing mode";
+    PCB_TRACE(lcTools) << "Entering track drawing mode";
 }
 
 bool TrackDrawingTool::onMousePress(QMouseEvent* event)
@@ -28,10 +30,10 @@ bool TrackDrawingTool::onMousePress(QMouseEvent* event)
         if (!(event->modifiers() & Qt::ShiftModifier))
         {
             QGraphicsItem* item = m_editor->itemAt(event->pos());
-            if (item && dynamic_cast<Link*>(item))
+            if (Link* link = item_cast<Link>(item))
             {
                 m_selectedItem = item;
-                m_editor->showStatusMessage(QString("Selected track %1").arg((dynamic_cast<Link*>(m_selectedItem))->m_id));
+                m_editor->showStatusMessage(QString("Selected track %1").arg(link->m_id));
             }
             else
             {
@@ -59,6 +61,13 @@ bool TrackDrawingTool::onMouseMove(QMouseEvent* event)
         qreal x1 = mousePos.x();
         qreal y1 = mousePos.y();
 
+        // snap the indicator to the node the track would end at
+        if (Node* node = NodeIndex::nearest(mousePos))
+        {
+            x1 = node->scenePos().x();
+            y1 = node->scenePos().y();
+        }
+
         if (event->modifiers() & Qt::ControlModifier)
         {
             //QPointF snapped = snapToNearest45Degrees(x0, y0, x1, y1);
@@ -77,11 +86,11 @@ bool TrackDrawingTool::onMouseDoubleClick(QMouseEvent* event)
     if (event->button() == Qt::LeftButton)
     {
         QGraphicsItem* item = m_editor->itemAt(event->pos());
-        if (item && dynamic_cast<Link*>(item))
+        if (Link* link = item_cast<Link>(item))
         {
-            qDebug() << "double click on" << item;
+            PCB_TRACE(lcTools) << "double click on" << item;
             toggleHighlightSubCircuit(m_highlighted_sub_circuit, false);
-            toggleHighlightSubCircuit(dynamic_cast<Link*>(item)->m_graphId, true);
+            toggleHighlightSubCircuit(link->m_graphId, true);
         }
     }
     return true;
@@ -103,9 +112,8 @@ bool TrackDrawingTool::onKeyRelease(QKeyEvent* event)
         m_editor->hideTracingIndicator();
     }
 
-    if (m_selectedItem && dynamic_cast<Link*>(m_selectedItem))
+    if (Link* selectedLink = item_cast<Link>(m_selectedItem))
     {
-        Link* selectedLink = dynamic_cast<Link*>(m_selectedItem);
         if (event->key() == Qt::Key_F || event->key() == Qt::Key_B || event->key() == Qt::Key_W)
         {
             if (event->key() == Qt::Key_F)
@@ -115,7 +123,7 @@ bool TrackDrawingTool::onKeyRelease(QKeyEvent* event)
             else if (event->key() == Qt::Key_B)
             {
                 m_editor->setCurrentSide(LinkSide::BACK);
-                qDebug() << "steo back";
+                PCB_TRACE(lcTools) << "steo back";
             }
             else
             {
@@ -169,7 +177,11 @@ bool TrackDrawingTool::onKeyRelease(QKeyEvent* event)
 void TrackDrawingTool::startDrawing(QMouseEvent* event)
 {
     m_drawing = true;
-    m_drawingLineFrom = m_editor->itemAt(event->pos());
+
+    // nodes are resolved through the node index, the scene is asked only for tracks
+    QPointF scenePos = m_editor->mapToScene(event->pos());
+    Node* node = NodeIndex::nearest(scenePos);
+    m_drawingLineFrom = node ? node : m_editor->itemAt(event->pos());
 
     /*
     if (m_drawing_line_from && dynamic_cast<ImageLayer*>(m_drawing_line_from))
@@ -178,31 +190,35 @@ void TrackDrawingTool::startDrawing(QMouseEvent* event)
     }
     */
 
-    m_drawingLineFromPos = m_editor->mapToScene(event->pos());
+    m_drawingLineFromPos = node ? node->scenePos() : scenePos;
 }
 
 void TrackDrawingTool::closeDrawing(QMouseEvent* event)
 {
     m_drawing = false;
-    QGraphicsItem* item = m_editor->itemAt(event->pos());
+    Node* node = NodeIndex::nearest(m_editor->mapToScene(event->pos()));
+    QGraphicsItem* item = node ? node : m_editor->itemAt(event->pos());
     
 
-    qDebug() << "drawing started from position:" << m_drawingLineFromPos;
-    qDebug() << "drawing started from item:" << m_drawingLineFrom;
+    PCB_TRACE(lcTools) << "drawing started from position:" << m_drawingLineFromPos;
+    PCB_TRACE(lcTools) << "drawing started from item:" << m_drawingLineFrom;
 
-    if (!isDynamicCastableToAny<Node, Link, Pad>(item))
+    if (!isItemOfAny<Node, Link>(item))
     {
         item = nullptr;
-        qDebug() << "drawing stopped at" << item;
+        PCB_TRACE(lcTools) << "drawing stopped at" << item;
     } 
     
-    if (dynamic_cast<Node*>(item) && dynamic_cast<Node*>(m_drawingLineFrom) && m_drawingLineFrom && dynamic_cast<Node*>(item)->m_id == dynamic_cast<Node*>(m_drawingLineFrom)->m_id)
+    Node* toNode = item_cast<Node>(item);
+    Node* fromNode = item_cast<Node>(m_drawingLineFrom);
+    if (toNode && fromNode && toNode->m_id == fromNode->m_id)
     {
         item = nullptr;
     }
 
         
-        if (dynamic_cast<Link*>(item) && (dynamic_cast<Link*>(item))->m_side != m_editor->m_currentSide)
+        Link* toLink = item_cast<Link>(item);
+        if (toLink && toLink->m_side != m_editor->m_currentSide)
         {
             m_editor->hideTracingIndicator();
             QMessageBox::StandardButton reply = QMessageBox::question(
@@ -210,7 +226,7 @@ void TrackDrawingTool::closeDrawing(QMouseEvent* event)
                 "Connect track on different sides",
                 QString("Do you want to connect this %1 track to track on the %2?")
                     .arg(static_cast<int>(m_editor->m_currentSide))
-                    .arg(static_cast<int>(dynamic_cast<Link*>(item)->m_side)),
+                    .arg(static_cast<int>(toLink->m_side)),
                 QMessageBox::Yes | QMessageBox::No
             );
             if (reply == QMessageBox::No)
@@ -224,13 +240,10 @@ void TrackDrawingTool::closeDrawing(QMouseEvent* event)
 
     std::optional<int> fromNodeId; 
     
-    if (dynamic_cast<Node*>(m_drawingLineFrom))
+    if (fromNode)
     {
-        fromNodeId = dynamic_cast<Node*>(m_drawingLineFrom)->m_id;
-    }
-    else if (dynamic_cast<Pad*>(m_drawingLineFrom))
-    {
-        fromNodeId = dynamic_cast<Pad*>(m_drawingLineFrom)->m_id;
+        // item_cast<Node> also accepts pads
+        fromNodeId = fromNode->m_id;
     }
 
     TrackCreationMeta meta{fromNodeId, startingPoint, endingPoint, item, m_editor->m_currentSide};
@@ -245,14 +258,10 @@ void TrackDrawingTool::toggleHighlightSubCircuit(int graphId, bool isHighlighted
 {
     if (graphId)
     {
-        QList<QGraphicsItem*> items = m_editor->scene()->items();
-        for (QGraphicsItem* item : items)
+        // only the links of this net are touched
+        for (Link* link : TrackGraph::links(graphId))
         {
-            Link* link = dynamic_cast<Link*>(item);
-            if (link && link->m_graphId == graphId)
-            {
-                link->setHighlighted(isHighlighted);
-            }
+            link->setHighlighted(isHighlighted);
         }
 
         if (isHighlighted)
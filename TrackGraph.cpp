@@ -0,0 +1,212 @@
+#include "TrackGraph.h"
+#include "Link.h"
+#include "Node.h"
+#include "Component.h"
+#include <stdexcept>
+
+/*
+ * Статическая переменная TrackGraph::count - счетчик графов трассировки
+ */
+int TrackGraph::count = 0;
+
+/*
+ * Статическая переменная TrackGraph::m_nets - состав каждой цепи
+ */
+std::unordered_map<int, TrackGraph::Net> TrackGraph::m_nets;
+
+/*
+ * Функция TrackGraph::genTrackGraphId - генерация ID графа трассировки
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   int - новый ID графа, не занятый ни одной цепью
+ */
+int TrackGraph::genTrackGraphId()
+{
+    // бинарный формат не хранит счетчик графов, поэтому пропускаем занятые ID
+    do
+    {
+        count++;
+    } while (m_nets.find(count) != m_nets.end());
+    return count;
+}
+
+/*
+ * Функция TrackGraph::setTrackGraphCount - установка счетчика графов трассировки
+ * Входные параметры:
+ *   count - новое значение счетчика
+ * Выходные данные:
+ *   отсутствуют
+ */
+void TrackGraph::setTrackGraphCount(int count)
+{
+    if (count >= 0)
+    {
+        TrackGraph::count = count;
+    }
+    else
+    {
+        throw std::invalid_argument("count must be a non-negative integer");
+    }
+}
+
+/*
+ * Функция TrackGraph::attach - добавление связи в ее цепь
+ * Входные параметры:
+ *   link - связь, добавленная на сцену
+ * Выходные данные:
+ *   отсутствуют
+ */
+void TrackGraph::attach(Link *link)
+{
+    Net &net = m_nets[link->m_graphId];
+    if (net.links.insert(link).second)
+    {
+        addEndpoint(net, link->fromNode());
+        addEndpoint(net, link->toNode());
+    }
+}
+
+/*
+ * Функция TrackGraph::detach - удаление связи из ее цепи
+ * Входные параметры:
+ *   link - связь, убранная со сцены
+ * Выходные данные:
+ *   bool - true, если связь была в цепи
+ */
+bool TrackGraph::detach(Link *link)
+{
+    auto it = m_nets.find(link->m_graphId);
+    if (it == m_nets.end() || it->second.links.erase(link) == 0)
+    {
+        return false;
+    }
+    removeEndpoint(it->second, link->fromNode());
+    removeEndpoint(it->second, link->toNode());
+    if (it->second.links.empty())
+    {
+        m_nets.erase(it);
+    }
+    return true;
+}
+
+/*
+ * Функция TrackGraph::relabel - перенос связи в цепь с ее текущим ID графа
+ * Входные параметры:
+ *   link - связь с уже обновленным m_graphId
+ *   oldGraphId - предыдущий ID графа связи
+ * Выходные данные:
+ *   отсутствуют
+ */
+void TrackGraph::relabel(Link *link, int oldGraphId)
+{
+    auto it = m_nets.find(oldGraphId);
+    if (it == m_nets.end() || it->second.links.erase(link) == 0)
+    {
+        // связи нет на сцене, ее цепь будет учтена при attach
+        return;
+    }
+    removeEndpoint(it->second, link->fromNode());
+    removeEndpoint(it->second, link->toNode());
+    if (it->second.links.empty())
+    {
+        m_nets.erase(it);
+    }
+    attach(link);
+}
+
+/*
+ * Функция TrackGraph::links - множество связей цепи
+ * Входные параметры:
+ *   graphId - ID графа
+ * Выходные данные:
+ *   множество связей цепи (пустое, если цепь не найдена)
+ */
+const std::unordered_set<Link *> &TrackGraph::links(int graphId)
+{
+    return net(graphId).links;
+}
+
+/*
+ * Функция TrackGraph::pads - контакты компонентов цепи
+ * Входные параметры:
+ *   graphId - ID графа
+ * Выходные данные:
+ *   словарь контакт -> число связей цепи, подключенных к контакту
+ */
+const std::unordered_map<const Node *, int> &TrackGraph::pads(int graphId)
+{
+    return net(graphId).pads;
+}
+
+/*
+ * Функция TrackGraph::nets - все цепи
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   словарь ID графа -> состав цепи
+ */
+const std::unordered_map<int, TrackGraph::Net> &TrackGraph::nets()
+{
+    return m_nets;
+}
+
+/*
+ * Функция TrackGraph::clear - очистка всех цепей
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   отсутствуют
+ */
+void TrackGraph::clear()
+{
+    m_nets.clear();
+}
+
+/*
+ * Функция TrackGraph::net - состав цепи по ID графа
+ * Входные параметры:
+ *   graphId - ID графа
+ * Выходные данные:
+ *   состав цепи (пустой, если цепь не найдена)
+ */
+const TrackGraph::Net &TrackGraph::net(int graphId)
+{
+    static const Net empty;
+    auto it = m_nets.find(graphId);
+    return it != m_nets.end() ? it->second : empty;
+}
+
+/*
+ * Функция TrackGraph::addEndpoint - учет узла на конце связи цепи
+ * Входные параметры:
+ *   net - цепь
+ *   node - узел (может быть nullptr, если связь еще не подключена)
+ * Выходные данные:
+ *   отсутствуют
+ */
+void TrackGraph::addEndpoint(Net &net, Node *node)
+{
+    // связь только что появилась на сцене, ее узлы живы
+    if (item_cast<Pad>(node))
+    {
+        net.pads[node]++;
+    }
+}
+
+/*
+ * Функция TrackGraph::removeEndpoint - снятие учета узла на конце связи цепи
+ * Входные параметры:
+ *   net - цепь
+ *   node - узел (может быть nullptr или уже удален: используется только его адрес)
+ * Выходные данные:
+ *   отсутствуют
+ */
+void TrackGraph::removeEndpoint(Net &net, const Node *node)
+{
+    auto it = net.pads.find(node);
+    if (it != net.pads.end() && --it->second == 0)
+    {
+        net.pads.erase(it);
+    }
+}
@@ -0,0 +1,69 @@
+#ifndef TRACKGRAPH_H
+#define TRACKGRAPH_H
+
+#include <unordered_map>
+#include <unordered_set>
+
+class Link;
+class Node;
+
+/*
+ * Класс TrackGraph - граф трассировки (цепи платы)
+ *
+ * Хранит состав цепей: для каждого ID графа - связи, находящиеся на сцене, а также
+ * контакты на их концах. Позволяет получить состав цепи без обхода сцены.
+ * Текущая цепь связи хранится в Link::m_graphId, поэтому запрос "в какой цепи связь" - O(1).
+ *
+ * Узлы на концах связи разыменовываются только при attach, когда связь на сцене и ее
+ * узлы живы. detach и relabel находят контакты по адресу узла и не обращаются к нему:
+ * связь, убранная со сцены, может пережить свои узлы (стек отмены удаляет команды
+ * от старых к новым, и узлы старой команды удаляются раньше связей следующей).
+ *
+ * Основные функции:
+ * 1. genTrackGraphId() - генерация ID графа трассировки
+ * 2. setTrackGraphCount(int count) - установка счетчика графов трассировки
+ * 3. attach(Link* link) - добавление связи в ее цепь (связь появилась на сцене)
+ * 4. detach(Link* link) - удаление связи из ее цепи (связь убрана со сцены)
+ * 5. relabel(Link* link, int oldGraphId) - перенос связи в новую цепь после смены ID графа
+ * 6. links(int graphId) - множество связей цепи
+ * 7. pads(int graphId) - контакты цепи
+ * 8. nets() - все цепи
+ * 9. clear() - очистка всех цепей
+ */
+class TrackGraph
+{
+public:
+    /*
+     * Состав цепи. Для контактов хранится число связей цепи, подключенных к ним,
+     * чтобы их можно было убирать инкрементально. Ключ - узел-контакт (Pad), по адресу
+     * которого его можно найти, не разыменовывая.
+     */
+    struct Net
+    {
+        std::unordered_set<Link *> links;
+        std::unordered_map<const Node *, int> pads;
+    };
+
+    static int count;
+
+    static int genTrackGraphId();
+    static void setTrackGraphCount(int count);
+
+    static void attach(Link *link);
+    static bool detach(Link *link);
+    static void relabel(Link *link, int oldGraphId);
+
+    static const std::unordered_set<Link *> &links(int graphId);
+    static const std::unordered_map<const Node *, int> &pads(int graphId);
+    static const std::unordered_map<int, Net> &nets();
+    static void clear();
+
+private:
+    static const Net &net(int graphId);
+    static void addEndpoint(Net &net, Node *node);
+    static void removeEndpoint(Net &net, const Node *node);
+
+    static std::unordered_map<int, Net> m_nets;
+};
+
+#endif // TRACKGRAPH_H
@@ -3,7 +3,72 @@
 #include <type_traits>
 #include <QGraphicsItem>
 
-template<typename... Ts>
-bool isDynamicCastableToAny(const QGraphicsItem* item) {
-    return (... || (dynamic_cast<const Ts*>(item) != nullptr));
-}
\ No newline at end of file
+/**
+ * @brief Значения QGraphicsItem::type() для элементов сцены редактора
+ *
+ * Наследники Node идут подряд сразу за ним: item_cast<Node> принимает весь диапазон
+ * [NodeItem, PhantomPadItem]. Новый наследник Node добавляется внутрь этого диапазона
+ * с обновлением Node::LastType.
+ */
+enum ItemType : int
+{
+    NodeItem = QGraphicsItem::UserType + 1, ///< Узел
+    PadItem,                                ///< Контакт компонента
+    PhantomPadItem,                         ///< Виртуальный контакт компонента
+    LinkItem,                               ///< Связь
+    ComponentItem,                          ///< Компонент
+    TextNoteItem,                           ///< Текстовая заметка
+    ImageLayerItem,                         ///< Слой изображения
+    ItemLayerItem                           ///< Слой графических элементов
+};
+
+/**
+ * @brief Проверяет, является ли элемент экземпляром T или его наследника
+ *
+ * Сравнивает только значение type(), без RTTI. T объявляет Type и LastType -
+ * последнее значение диапазона своих наследников (у классов без наследников LastType = Type).
+ * @param item Элемент сцены (может быть nullptr)
+ * @return true если элемент относится к T
+ */
+template <typename T>
+bool isItemOf(const QGraphicsItem *item)
+{
+    using Item = std::remove_cv_t<T>;
+    if (!item)
+    {
+        return false;
+    }
+    const int type = item->type();
+    return type >= Item::Type && type <= Item::LastType;
+}
+
+/**
+ * @brief Быстрое приведение элемента сцены по его type()
+ *
+ * Замена dynamic_cast для элементов редактора: одно виртуальное обращение
+ * и сравнение целых вместо обхода информации о типах.
+ * @param item Элемент сцены (может быть nullptr)
+ * @return Указатель на элемент как T или nullptr
+ */
+template <typename T>
+T *item_cast(QGraphicsItem *item)
+{
+    return isItemOf<T>(item) ? static_cast<T *>(item) : nullptr;
+}
+
+template <typename T>
+const T *item_cast(const QGraphicsItem *item)
+{
+    return isItemOf<T>(item) ? static_cast<const T *>(item) : nullptr;
+}
+
+/**
+ * @brief Проверяет, относится ли элемент хотя бы к одному из типов Ts
+ * @param item Элемент сцены (может быть nullptr)
+ * @return true если isItemOf верно хотя бы для одного типа
+ */
+template <typename... Ts>
+bool isItemOfAny(const QGraphicsItem *item)
+{
+    return (... || isItemOf<Ts>(item));
+}
@@ -0,0 +1,313 @@
+#include "UndoHistory.h"
+#include "actions/IPagedCommand.h"
+#include <QUndoStack>
+#include <QDebug>
+#include <algorithm>
+
+/*
+ * Функция UndoSpillFile::write - запись во временный файл
+ * Входные параметры:
+ *   data - запись
+ * Выходные данные:
+ *   qint64 - смещение записи или -1 при ошибке
+ */
+qint64 UndoSpillFile::write(const QByteArray &data)
+{
+    if (!m_file.isOpen() && !m_file.open())
+    {
+        qWarning() << "Cannot create the undo history file:" << m_file.errorString();
+        return -1;
+    }
+
+    // Наименьший свободный участок, в который помещается запись, иначе конец файла
+    const qint64 size = data.size();
+    qint64 offset = m_size;
+    auto fit = m_freeBySize.lower_bound(size);
+    if (fit != m_freeBySize.end())
+    {
+        offset = fit->second;
+    }
+    if (!m_file.seek(offset) || m_file.write(data) != size)
+    {
+        qWarning() << "Cannot write the undo history file:" << m_file.errorString();
+        return -1;
+    }
+
+    if (fit != m_freeBySize.end())
+    {
+        const qint64 extentSize = fit->first;
+        takeFree(m_freeByOffset.find(offset));
+        if (extentSize > size)
+        {
+            // остаток участка остается свободным
+            m_freeByOffset.emplace(offset + size, extentSize - size);
+            m_freeBySize.emplace(extentSize - size, offset + size);
+        }
+    }
+    else
+    {
+        m_size += size;
+    }
+    m_liveBytes += size;
+    return offset;
+}
+
+/*
+ * Функция UndoSpillFile::release - освобождение места записи
+ * Входные параметры:
+ *   offset - смещение записи
+ *   size - размер записи
+ * Выходные данные:
+ *   отсутствуют
+ */
+void UndoSpillFile::release(qint64 offset, int size)
+{
+    m_liveBytes -= size;
+    qint64 begin = offset;
+    qint64 end = offset + size;
+
+    // Объединение с соседними свободными участками
+    auto next = m_freeByOffset.lower_bound(begin);
+    if (next != m_freeByOffset.end() && next->first == end)
+    {
+        end += next->second;
+        takeFree(next);
+    }
+    auto previous = m_freeByOffset.lower_bound(begin);
+    if (previous != m_freeByOffset.begin())
+    {
+        --previous;
+        if (previous->first + previous->second == begin)
+        {
+            begin = previous->first;
+            takeFree(previous);
+        }
+    }
+
+    if (end == m_size)
+    {
+        // свободный хвост отрезается
+        m_size = begin;
+        m_file.resize(m_size);
+        return;
+    }
+    m_freeByOffset.emplace(begin, end - begin);
+    m_freeBySize.emplace(end - begin, begin);
+}
+
+/*
+ * Функция UndoSpillFile::takeFree - удаление участка из списков свободного места
+ * Входные параметры:
+ *   extent - участок в m_freeByOffset
+ * Выходные данные:
+ *   отсутствуют
+ */
+void UndoSpillFile::takeFree(std::map<qint64, qint64>::iterator extent)
+{
+    auto range = m_freeBySize.equal_range(extent->second);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second == extent->first)
+        {
+            m_freeBySize.erase(it);
+            break;
+        }
+    }
+    m_freeByOffset.erase(extent);
+}
+
+/*
+ * Функция UndoSpillFile::read - чтение записи
+ * Входные параметры:
+ *   offset - смещение записи
+ *   size - размер записи
+ * Выходные данные:
+ *   QByteArray - запись (пустая при ошибке)
+ */
+QByteArray UndoSpillFile::read(qint64 offset, int size)
+{
+    if (!m_file.isOpen() || !m_file.seek(offset))
+    {
+        return QByteArray();
+    }
+    QByteArray data = m_file.read(size);
+    return data.size() == size ? data : QByteArray();
+}
+
+/*
+ * Функция UndoSpillFile::reset - очистка файла
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   отсутствуют
+ */
+void UndoSpillFile::reset()
+{
+    if (m_file.isOpen())
+    {
+        m_file.resize(0);
+    }
+    m_size = 0;
+    m_liveBytes = 0;
+    m_freeByOffset.clear();
+    m_freeBySize.clear();
+}
+
+/*
+ * Функция UndoHistory::UndoHistory - подключение к стеку отмены
+ * Входные параметры:
+ *   stack - стек отмены редактора
+ *   budget - бюджет памяти в байтах
+ * Выходные данные:
+ *   отсутствуют
+ */
+UndoHistory::UndoHistory(QUndoStack *stack, size_t budget) : m_stack(stack), m_budget(budget)
+{
+    m_connection = QObject::connect(stack, &QUndoStack::indexChanged, stack, [this](int index)
+                                    { indexChanged(index); });
+}
+
+/*
+ * Функция UndoHistory::~UndoHistory - очистка стека отмены
+ *
+ * Вытесненные записи освобождают место в файле при удалении команд,
+ * поэтому команды удаляются раньше файла.
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   отсутствуют
+ */
+UndoHistory::~UndoHistory()
+{
+    m_stack->clear();
+    QObject::disconnect(m_connection);
+}
+
+/*
+ * Функция UndoHistory::setMemoryBudget - установка бюджета памяти
+ * Входные параметры:
+ *   bytes - бюджет в байтах
+ * Выходные данные:
+ *   отсутствуют
+ */
+void UndoHistory::setMemoryBudget(size_t bytes)
+{
+    m_budget = bytes;
+    indexChanged(m_stack->index());
+}
+
+/*
+ * Функция UndoHistory::memoryUsage - оценка памяти записей выполненных команд
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   size_t - память в байтах
+ */
+size_t UndoHistory::memoryUsage() const
+{
+    size_t usage = 0;
+    for (int i = 0; i < m_stack->index(); ++i)
+    {
+        if (IPagedCommand *command = pagedCommand(i))
+        {
+            usage += command->memoryUsage();
+        }
+    }
+    return usage;
+}
+
+/*
+ * Функция UndoHistory::pagedCommand - команда стека с IPagedCommand
+ * Входные параметры:
+ *   index - индекс команды в стеке
+ * Выходные данные:
+ *   IPagedCommand* - команда или nullptr, если она не поддерживает сжатие
+ */
+IPagedCommand *UndoHistory::pagedCommand(int index) const
+{
+    // QUndoStack отдает команды только для чтения, а сжатие меняет их данные
+    QUndoCommand *command = const_cast<QUndoCommand *>(m_stack->command(index));
+    return dynamic_cast<IPagedCommand *>(command);
+}
+
+/*
+ * Функция UndoHistory::liveUsage - память записей команд, еще не сжатых
+ * Входные параметры:
+ *   index - индекс стека
+ * Выходные данные:
+ *   size_t - память команд [m_compactedUpTo, index) в байтах
+ */
+size_t UndoHistory::liveUsage(int index) const
+{
+    size_t usage = 0;
+    for (int i = m_compactedUpTo; i < index; ++i)
+    {
+        if (IPagedCommand *command = pagedCommand(i))
+        {
+            usage += command->memoryUsage();
+        }
+    }
+    return usage;
+}
+
+/*
+ * Функция UndoHistory::indexChanged - сжатие и вытеснение старых команд
+ *
+ * Границы m_compactedUpTo и m_spilledUpTo только растут вместе с индексом стека,
+ * поэтому каждая команда сжимается и вытесняется один раз. Отмена ниже границы
+ * загружает команды обратно, и границы опускаются до индекса.
+ * Входные параметры:
+ *   index - новый индекс стека
+ * Выходные данные:
+ *   отсутствуют
+ */
+void UndoHistory::indexChanged(int index)
+{
+    if (m_stack->count() == 0)
+    {
+        // стек очищен, записи в файле больше не нужны
+        m_compactedUpTo = 0;
+        m_spilledUpTo = 0;
+        m_compactBytes = 0;
+        m_spillFile.reset();
+        return;
+    }
+
+    if (index < m_compactedUpTo)
+    {
+        m_compactedUpTo = index;
+        m_spilledUpTo = std::min(m_spilledUpTo, m_compactedUpTo);
+        m_compactBytes = 0;
+        for (int i = m_spilledUpTo; i < m_compactedUpTo; ++i)
+        {
+            if (IPagedCommand *command = pagedCommand(i))
+            {
+                m_compactBytes += command->memoryUsage();
+            }
+        }
+    }
+
+    // Сжатие выполненных команд, кроме LiveCommands последних
+    const int compactEnd = std::max(0, index - LiveCommands);
+    for (; m_compactedUpTo < compactEnd; ++m_compactedUpTo)
+    {
+        if (IPagedCommand *command = pagedCommand(m_compactedUpTo))
+        {
+            command->compact();
+            m_compactBytes += command->memoryUsage();
+        }
+    }
+
+    // Вытеснение самых старых записей, пока история не уложится в бюджет
+    const size_t live = liveUsage(index);
+    while (m_compactBytes + live > m_budget && m_spilledUpTo < m_compactedUpTo)
+    {
+        if (IPagedCommand *command = pagedCommand(m_spilledUpTo))
+        {
+            m_compactBytes -= command->memoryUsage();
+            command->spill(&m_spillFile);
+            m_compactBytes += command->memoryUsage();
+        }
+        ++m_spilledUpTo;
+    }
+}
@@ -0,0 +1,148 @@
+#ifndef UNDOHISTORY_H
+#define UNDOHISTORY_H
+
+#include <QByteArray>
+#include <QObject>
+#include <QTemporaryFile>
+#include <cstddef>
+#include <map>
+
+class QUndoStack;
+class IPagedCommand;
+
+/**
+ * @brief Временный файл для записей истории отмены, вытесненных из памяти
+ *
+ * Файл создается при первой записи. Место записи освобождается, когда команда
+ * загружает ее обратно или удаляется стеком; свободные участки соседних записей
+ * объединяются, новая запись занимает наименьший подходящий участок, а свободный
+ * хвост файла отрезается. Поэтому многократная отмена и повтор через границу
+ * сжатия не увеличивают файл.
+ */
+class UndoSpillFile
+{
+public:
+    /**
+     * @brief Записывает запись в свободный участок или в конец файла
+     * @param data Запись
+     * @return Смещение записи в файле или -1 при ошибке
+     */
+    qint64 write(const QByteArray &data);
+
+    /**
+     * @brief Освобождает место записи
+     * @param offset Смещение записи
+     * @param size Размер записи
+     */
+    void release(qint64 offset, int size);
+
+    /**
+     * @brief Читает запись
+     * @param offset Смещение записи
+     * @param size Размер записи
+     * @return Запись (пустая при ошибке)
+     */
+    QByteArray read(qint64 offset, int size);
+
+    /**
+     * @brief Очищает файл
+     */
+    void reset();
+
+    /**
+     * @brief Возвращает размер файла
+     * @return Размер в байтах
+     */
+    qint64 size() const { return m_size; }
+
+    /**
+     * @brief Возвращает объем записей, еще находящихся в файле
+     * @return Размер в байтах
+     */
+    qint64 liveBytes() const { return m_liveBytes; }
+
+private:
+    void takeFree(std::map<qint64, qint64>::iterator extent);
+
+    QTemporaryFile m_file;  ///< Файл записей
+    qint64 m_size = 0;      ///< Конец последней записи
+    qint64 m_liveBytes = 0; ///< Объем записей в файле
+
+    std::map<qint64, qint64> m_freeByOffset;     ///< Свободные участки: смещение -> размер
+    std::multimap<qint64, qint64> m_freeBySize;  ///< Свободные участки: размер -> смещение
+};
+
+/**
+ * @brief Ограничение памяти записей истории отмены редактора
+ *
+ * Следит за индексом QUndoStack. Записи команд с IPagedCommand (изменения ID цепей
+ * AddTrack и DeleteTrack) остаются в полном виде, пока команда среди LiveCommands
+ * последних выполненных. Записи более старых команд сжимаются (ID связей разностями),
+ * а если записи превышают бюджет, самые старые из них переносятся во временный файл.
+ * При отмене команда сама загружает свою запись обратно.
+ *
+ * Бюджет относится только к этим записям. Элементы сцены, которыми владеют команды
+ * (например, связи, удаленные DeleteTrack), в него не входят и не вытесняются.
+ *
+ * Отмененные команды (выше индекса стека) не сжимаются: они только что загружены
+ * и удаляются стеком при следующем push.
+ *
+ * Основные функции:
+ * 1. setMemoryBudget(bytes) - бюджет памяти записей
+ * 2. memoryUsage() - оценка памяти записей выполненных команд
+ * 3. spilledBytes() - объем записей во временном файле
+ */
+class UndoHistory
+{
+public:
+    /// Число последних выполненных команд, которые не сжимаются
+    static constexpr int LiveCommands = 32;
+
+    /**
+     * @brief Подключается к стеку отмены
+     * @param stack Стек отмены редактора
+     * @param budget Бюджет памяти в байтах
+     */
+    UndoHistory(QUndoStack *stack, size_t budget);
+
+    /**
+     * @brief Очищает стек отмены, пока файл записей еще существует
+     */
+    ~UndoHistory();
+
+    /**
+     * @brief Устанавливает бюджет памяти записей и сразу применяет его
+     * @param bytes Бюджет в байтах
+     */
+    void setMemoryBudget(size_t bytes);
+
+    size_t memoryBudget() const { return m_budget; }
+
+    /**
+     * @brief Оценивает память записей выполненных команд с IPagedCommand
+     * @return Память в байтах
+     */
+    size_t memoryUsage() const;
+
+    /**
+     * @brief Возвращает объем записей, перенесенных во временный файл
+     * @return Размер в байтах
+     */
+    qint64 spilledBytes() const { return m_spillFile.liveBytes(); }
+
+private:
+    void indexChanged(int index);
+    IPagedCommand *pagedCommand(int index) const;
+    size_t liveUsage(int index) const;
+
+    QUndoStack *m_stack;        ///< Стек отмены
+    QMetaObject::Connection m_connection; ///< Подписка на indexChanged
+    size_t m_budget;            ///< Бюджет памяти, байт
+    UndoSpillFile m_spillFile;  ///< Файл вытесненных записей
+
+    int m_compactedUpTo = 0;    ///< Записи команд [0, m_compactedUpTo) сжаты или вытеснены
+    int m_spilledUpTo = 0;      ///< Записи команд [0, m_spilledUpTo) вытеснены
+    size_t m_compactBytes = 0;  ///< Память команд [m_spilledUpTo, m_compactedUpTo)
+};
+
+#endif // UNDOHISTORY_H
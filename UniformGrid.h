@@ -0,0 +1,199 @@
+#ifndef UNIFORMGRID_H
+#define UNIFORMGRID_H
+
+#include <QPointF>
+#include <QtGlobal>
+#include <cmath>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Равномерная сетка для поиска ближайшей точки
+ *
+ * UniformGrid хранит значения с позициями в ячейках квадратной сетки. Занятые ячейки
+ * лежат в хеш-таблице, поэтому размер сцены не ограничен. Вставка, перемещение и удаление
+ * выполняются за O(1), поиск ближайшего значения в радиусе R просматривает только ячейки,
+ * пересекающие квадрат 2R x 2R, - при размере ячейки порядка R это O(1) в среднем
+ * и не зависит от общего числа значений.
+ *
+ * @tparam T Тип значения (указатель или целое), должен быть ключом std::unordered_map
+ */
+template <typename T>
+class UniformGrid
+{
+public:
+    /**
+     * @brief Конструктор сетки
+     * @param cellSize Размер ячейки в единицах сцены
+     */
+    explicit UniformGrid(qreal cellSize) : m_cellSize(cellSize) {}
+
+    /**
+     * @brief Добавляет значение или перемещает уже добавленное
+     * @param value Значение
+     * @param pos Позиция значения
+     */
+    void insert(T value, const QPointF &pos)
+    {
+        quint64 cell = cellKey(pos);
+        auto it = m_locators.find(value);
+        if (it != m_locators.end())
+        {
+            Locator &locator = it->second;
+            if (locator.cell == cell)
+            {
+                m_cells[cell][locator.slot].pos = pos;
+                return;
+            }
+            take(locator);
+            place(value, pos, cell, locator);
+            return;
+        }
+        place(value, pos, cell, m_locators[value]);
+    }
+
+    /**
+     * @brief Удаляет значение
+     * @param value Значение
+     * @return true если значение было в сетке
+     */
+    bool remove(T value)
+    {
+        auto it = m_locators.find(value);
+        if (it == m_locators.end())
+        {
+            return false;
+        }
+        take(it->second);
+        m_locators.erase(it);
+        return true;
+    }
+
+    /**
+     * @brief Ищет ближайшее значение в радиусе
+     * @param pos Точка поиска
+     * @param radius Радиус поиска
+     * @param accept Фильтр значений: bool(T), отклоненные значения пропускаются
+     * @return Ближайшее значение или пусто, если в радиусе нет подходящих
+     */
+    template <typename Accept>
+    std::optional<T> nearest(const QPointF &pos, qreal radius, Accept accept) const
+    {
+        std::optional<T> result;
+        qreal best = radius * radius;
+
+        qint32 x0 = cellCoord(pos.x() - radius);
+        qint32 x1 = cellCoord(pos.x() + radius);
+        qint32 y0 = cellCoord(pos.y() - radius);
+        qint32 y1 = cellCoord(pos.y() + radius);
+        for (qint32 y = y0; y <= y1; ++y)
+        {
+            for (qint32 x = x0; x <= x1; ++x)
+            {
+                auto cell = m_cells.find(key(x, y));
+                if (cell == m_cells.end())
+                {
+                    continue;
+                }
+                for (const Entry &entry : cell->second)
+                {
+                    qreal dx = entry.pos.x() - pos.x();
+                    qreal dy = entry.pos.y() - pos.y();
+                    qreal distance = dx * dx + dy * dy;
+                    if (distance <= best && accept(entry.value))
+                    {
+                        best = distance;
+                        result = entry.value;
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Ищет ближайшее значение в радиусе без фильтра
+     * @param pos Точка поиска
+     * @param radius Радиус поиска
+     * @return Ближайшее значение или пусто
+     */
+    std::optional<T> nearest(const QPointF &pos, qreal radius) const
+    {
+        return nearest(pos, radius, [](const T &) { return true; });
+    }
+
+    /**
+     * @brief Возвращает число значений в сетке
+     * @return Число значений
+     */
+    size_t size() const { return m_locators.size(); }
+
+    /**
+     * @brief Удаляет все значения
+     */
+    void clear()
+    {
+        m_cells.clear();
+        m_locators.clear();
+    }
+
+private:
+    struct Entry
+    {
+        T value;
+        QPointF pos;
+    };
+
+    struct Locator
+    {
+        quint64 cell; ///< Ключ ячейки
+        size_t slot;  ///< Индекс в векторе ячейки
+    };
+
+    qint32 cellCoord(qreal v) const
+    {
+        return qint32(std::floor(v / m_cellSize));
+    }
+
+    static quint64 key(qint32 x, qint32 y)
+    {
+        return (quint64(quint32(x)) << 32) | quint32(y);
+    }
+
+    quint64 cellKey(const QPointF &pos) const
+    {
+        return key(cellCoord(pos.x()), cellCoord(pos.y()));
+    }
+
+    void place(T value, const QPointF &pos, quint64 cell, Locator &locator)
+    {
+        std::vector<Entry> &entries = m_cells[cell];
+        locator.cell = cell;
+        locator.slot = entries.size();
+        entries.push_back(Entry{value, pos});
+    }
+
+    // Последнее значение ячейки переносится на место удаляемого
+    void take(const Locator &locator)
+    {
+        auto cell = m_cells.find(locator.cell);
+        std::vector<Entry> &entries = cell->second;
+        if (locator.slot + 1 != entries.size())
+        {
+            entries[locator.slot] = entries.back();
+            m_locators[entries[locator.slot].value].slot = locator.slot;
+        }
+        entries.pop_back();
+        if (entries.empty())
+        {
+            m_cells.erase(cell);
+        }
+    }
+
+    qreal m_cellSize;
+    std::unordered_map<quint64, std::vector<Entry>> m_cells;
+    std::unordered_map<T, Locator> m_locators;
+};
+
+#endif // UNIFORMGRID_H
@@ -2,6 +2,9 @@
 #include <QScrollBar>
 #include <QTransform>
 #include <QDebug>
+#include "Trace.h"
+#include <QElapsedTimer>
+#include <QPaintEvent>
 #ifdef USE_OPENGL
 #include <QOpenGLWidget>
 #endif
@@ -65,7 +68,7 @@ void ZoomableGraphicsView::wheelEvent(QWheelEvent* event)
     if (event->modifiers() & Qt::ControlModifier) {
         if (event->angleDelta().y() > 0) {
             scale(scaleFactor, scaleFactor);
-            qDebug() << "Zooming in";
+            PCB_TRACE(lcView) << "Zooming in";
         } else {
             scale(1.0 / scaleFactor, 1.0 / scaleFactor);
         }
@@ -77,9 +80,9 @@ void ZoomableGraphicsView::wheelEvent(QWheelEvent* event)
 
 void ZoomableGraphicsView::mousePressEvent(QMouseEvent* event)
 {
-    qDebug() << "mouse press event: ";
+    PCB_TRACE(lcView) << "mouse press event: ";
     if (event->button() == Qt::MiddleButton) {
-        qDebug() << "button";
+        PCB_TRACE(lcView) << "button";
         isPanning = true;
         panStartPoint = event->pos();
         setCursor(Qt::ClosedHandCursor);
@@ -112,3 +115,16 @@ void ZoomableGraphicsView::mouseMoveEvent(QMouseEvent* event)
         QGraphicsView::mouseMoveEvent(event);
     }
 }
+
+void ZoomableGraphicsView::paintEvent(QPaintEvent* event)
+{
+#ifdef PCB_TRACER_TRACE
+    // frame times for comparing rendering changes: QT_LOGGING_RULES="pcbtracer.view.debug=true"
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+    PCB_TRACE(lcView) << "frame" << timer.nsecsElapsed() / 1000 << "us, exposed" << event->region().boundingRect();
+#else
+    QGraphicsView::paintEvent(event);
+#endif
+}
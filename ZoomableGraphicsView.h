@@ -3,6 +3,7 @@
 
 #include <QGraphicsView>
 #include <QMouseEvent>
+#include "TypeChecks.h"
 
 class ZoomableGraphicsView : public QGraphicsView
 {
@@ -22,6 +23,7 @@ protected:
     void mousePressEvent(QMouseEvent* event) override;
     void mouseReleaseEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
 
 private:
     void flipTransform(qreal flipX, qreal flipY);
@@ -35,7 +37,7 @@ template<typename T>
 T* ZoomableGraphicsView::findItemByIdAndClass(const QString& itemId) const
 {
     for (QGraphicsItem* item : scene()->items()) {
-        T* castedItem = dynamic_cast<T*>(item);
+        T* castedItem = item_cast<T>(item);
         if (castedItem && castedItem->id() == itemId) {
             return castedItem;
         }
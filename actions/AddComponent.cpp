@@ -1,12 +1,11 @@
 #include "AddComponent.h"
 #include "../Editor.h"
 #include "../Component.h"
+#include "../Trace.h"
 
 AddComponent::AddComponent(const AddComponentMeta& meta)
     : QUndoCommand(), m_meta(meta)
 {
-    qDebug() << m_componentId;
-
     m_scene = Editor::instance()->scene();
 
     m_component = new Component(m_meta.m_name, Component::genComponentId());
@@ -16,7 +15,7 @@ AddComponent::AddComponent(const AddComponentMeta& meta)
         m_component->addPad(meta.m_pads[i]);
     }
 
-    qDebug() << meta.m_name;
+    PCB_TRACE(lcScene) << "AddComponent:" << m_component->m_id << meta.m_name;
 }
 
 void AddComponent::undo()
@@ -2,9 +2,8 @@
 #include "../Editor.h"
 
 AddTrack::AddTrack(const TrackCreationMeta& meta)
-    : m_created_from_node(false), m_created_to_node(false), m_created_split_link(false),
+    : m_created_from_node(false), m_created_to_node(false),
       m_meta(meta),
-      m_is_split_link(false),
       m_link(nullptr), m_from_node(nullptr), m_to_node(nullptr) {
 
     m_scene = Editor::instance()->scene();
@@ -24,17 +23,16 @@ AddTrack::AddTrack(const TrackCreationMeta& meta)
 
     // if TO node is given, use it, else create a new node at the given position
     if (m_meta.m_to_item && m_meta.m_to_item->type() != Link::Type) {
-        m_to_node = dynamic_cast<Node*>(m_meta.m_to_item);
+        m_to_node = item_cast<Node>(m_meta.m_to_item);
     } else {
         m_to_node = new Node(Node::genNodeId());
         m_to_node->setPosition(m_meta.m_to_position);
         m_created_to_node = true;
         // if TO is a link, we need to split the clicked link
         if (m_meta.m_to_item && m_meta.m_to_item->type() == Link::Type) {
-            m_split_link_meta["new_link_a"] = QVariant::fromValue(new Link(Link::genLinkId()));
-            m_split_link_meta["new_link_b"] = QVariant::fromValue(new Link(Link::genLinkId()));
-            m_split_link_meta["delete_link"] = QVariant::fromValue((Link*)m_meta.m_to_item);
-            m_is_split_link = true; // maybe the map could be an optional so we can avoid using this
+            Link* new_link_a = new Link(Link::genLinkId());
+            Link* new_link_b = new Link(Link::genLinkId());
+            m_split_link = SplitLinkMeta{new_link_a, new_link_b, item_cast<Link>(m_meta.m_to_item)};
 
         }
     }
@@ -46,13 +44,14 @@ AddTrack::AddTrack(const TrackCreationMeta& meta)
 }
 
 AddTrack::~AddTrack() {
+    // the link goes first, it still refers to its nodes while leaving its net
+    delete m_link;
     if (m_created_from_node) {
         delete m_from_node;
     }
     if (m_created_to_node) {
         delete m_to_node;
     }
-    delete m_link;
 }
 
 void AddTrack::undo() {
@@ -67,34 +66,28 @@ void AddTrack::undo() {
         m_scene->removeItem(m_to_node);
     }
 
-    // remove links from nodes (update this to use link.remove)
-    m_from_node->removeLink(m_link);
-    m_to_node->removeLink(m_link);
-
-    // remove the link from the scene (update this to use link.remove)
-    m_scene->removeItem(m_link);
+    // remove the link from its nodes, the scene and its net
+    m_link->remove();
 
     // remove new segmented links if they were created
-    if (!m_split_link_meta.empty()) {
-        Link* new_link_a = m_split_link_meta["new_link_a"].value<Link*>();
-        Link* new_link_b = m_split_link_meta["new_link_b"].value<Link*>();
-        new_link_a->remove();
-        new_link_b->remove();
+    if (m_split_link) {
+        m_split_link->m_new_link_a->remove();
+        m_split_link->m_new_link_b->remove();
 
         // re-add deleted link
-        Link* deleted_link = m_split_link_meta["delete_link"].value<Link*>();
+        Link* deleted_link = m_split_link->m_delete_link;
         deleted_link->setSide(deleted_link->m_side);
-        deleted_link->setFromNode(m_split_link_meta["target_link_from_node"].value<Node*>());
-        deleted_link->setToNode(m_split_link_meta["target_link_to_node"].value<Node*>());
+        deleted_link->setFromNode(m_split_link->m_target_link_from_node);
+        deleted_link->setToNode(m_split_link->m_target_link_to_node);
     }
 
-    for (const auto& item : m_old_graph_ids) {
+    m_graph_id_changes.forEach([](const GraphIdChange& item) {
         Link* link_to_change = Editor::instance()->findItemByIdAndClass<Link>(item.m_link_id);
         if (link_to_change) {
             link_to_change->setGraphId(item.m_old_graph_id);
             link_to_change->updateTextItem(QString::number(item.m_old_graph_id));
         }
-    }
+    });
 
     if (!m_created_from_node) {
         m_from_node->notifyLinkChanges();
@@ -147,12 +140,12 @@ void AddTrack::redo() {
 
     m_link->refresh();
 
-    if (!m_split_link_meta.empty()) {
-        Link* link_to_remove = m_split_link_meta["delete_link"].value<Link*>();
-        m_split_link_meta["target_link_from_node"] = QVariant::fromValue(link_to_remove->fromNode());
-        m_split_link_meta["target_link_to_node"] = QVariant::fromValue(link_to_remove->toNode());
-        Link* new_link_a = m_split_link_meta["new_link_a"].value<Link*>();
-        Link* new_link_b = m_split_link_meta["new_link_b"].value<Link*>();
+    if (m_split_link) {
+        Link* link_to_remove = m_split_link->m_delete_link;
+        m_split_link->m_target_link_from_node = link_to_remove->fromNode();
+        m_split_link->m_target_link_to_node = link_to_remove->toNode();
+        Link* new_link_a = m_split_link->m_new_link_a;
+        Link* new_link_b = m_split_link->m_new_link_b;
         // 1- eliminar el link original
         link_to_remove->remove();
 
@@ -166,12 +159,12 @@ void AddTrack::redo() {
     }
 
     // update graph ids
-    for (const auto& item : m_old_graph_ids) {
+    m_graph_id_changes.forEach([](const GraphIdChange& item) {
         Link* link_to_change = Editor::instance()->findItemByIdAndClass<Link>(item.m_link_id);
         if (link_to_change) {
             link_to_change->setGraphId(item.m_new_graph_id);
         }
-    }
+    });
 
     // both were created or existing, but either way they had their number of links changed
     m_to_node->notifyLinkChanges();
@@ -194,101 +187,69 @@ void AddTrack::redo() {
 void AddTrack::calculateGraphIds() {
     
     if (m_from_node) {
-        std::vector<int> a, b;
+        // all the links of a node belong to the same net, so one link per end is enough
+        std::optional<int> from_graph_id, to_graph_id;
 
-        for (const auto& link : m_from_node->getLinks()) {
+        for (Link* link : m_from_node->links()) {
             if (link->m_id != m_link->m_id) {
-                a.push_back(link->m_graphId);
+                from_graph_id = link->m_graphId;
+                break;
             }
         }
 
-        for (const auto& link : m_to_node->getLinks()) {
+        for (Link* link : m_to_node->links()) {
             if (link->m_id != m_link->m_id) {
-                b.push_back(link->m_graphId);
+                to_graph_id = link->m_graphId;
+                break;
             }
         }
 
-        std::optional<int> max_graph_id, min_graph_id;
-
-        if(!(a.empty() && b.empty())) {
-            // we can rewrite this without using a temp array
-            std::vector<int> combined;
-            combined.insert(combined.end(), a.begin(), a.end());
-            combined.insert(combined.end(), b.begin(), b.end());
-            auto [min_it, max_it] = std::minmax_element(combined.begin(), combined.end());
-            min_graph_id = *min_it;
-            max_graph_id = *max_it;
-        }
-
-        if(!max_graph_id.has_value()) {
-            max_graph_id = TrackGraph::genTrackGraphId();
+        // when splitting a link, the new node joins the net of the split link
+        if (m_split_link) {
+            to_graph_id = m_split_link->m_delete_link->m_graphId;
         }
 
-
-        if (min_graph_id.has_value() && !a.empty() && !b.empty() && min_graph_id.value() != max_graph_id.value()) {
-            // updates the ones that have min_graph_id
-            for (auto item : m_scene->items()) {
-                if (auto link = dynamic_cast<Link*>(item)) {
-                    if (link->m_graphId == min_graph_id) {
-                        
-                        m_old_graph_ids.push_back(GraphIdChange{//+
-                            .m_link_id=link->m_id,//+
-                            .m_old_graph_id=min_graph_id.value(),//+
-                            .m_new_graph_id=max_graph_id.value()//+
-                        });                         
-
-                    }
-                }
+        int graph_id;
+        if (from_graph_id.has_value() && to_graph_id.has_value() && from_graph_id.value() != to_graph_id.value()) {
+            // merge the smaller net into the bigger one, so only the smaller net is relabeled
+            const auto& from_links = TrackGraph::links(from_graph_id.value());
+            const auto& to_links = TrackGraph::links(to_graph_id.value());
+            bool keep_from = from_links.size() >= to_links.size();
+            graph_id = keep_from ? from_graph_id.value() : to_graph_id.value();
+            int merged_graph_id = keep_from ? to_graph_id.value() : from_graph_id.value();
+
+            for (Link* link : keep_from ? to_links : from_links) {
+                m_graph_id_changes.add(link->m_id, merged_graph_id, graph_id);
             }
+        } else if (from_graph_id.has_value()) {
+            graph_id = from_graph_id.value();
+        } else if (to_graph_id.has_value()) {
+            graph_id = to_graph_id.value();
+        } else {
+            graph_id = TrackGraph::genTrackGraphId();
         }
 
+        m_link->setGraphId(graph_id);
+        m_link->updateTextItem(QString::number(graph_id));
 
-        m_link->setGraphId(max_graph_id.value());
-        m_link->updateTextItem(QString::number(max_graph_id.value()));
-
-        if(m_is_split_link) {
-            Link* link_to_remove = m_split_link_meta["delete_link"].value<Link*>();
-
-            m_old_graph_ids.push_back(GraphIdChange{ //+
-                .m_link_id=m_split_link_meta["new_link_a"].value<Link*>()->m_id, //+
-                .m_old_graph_id=m_split_link_meta["new_link_a"].value<Link*>()->m_graphId,
-                .m_new_graph_id=max_graph_id.value()//+
-            });  
-            m_old_graph_ids.push_back(GraphIdChange{ //+
-                .m_link_id=m_split_link_meta["new_link_b"].value<Link*>()->m_id, //+
-                .m_old_graph_id=m_split_link_meta["new_link_b"].value<Link*>()->m_graphId,
-                .m_new_graph_id=max_graph_id.value()//+
-            });  
- 
-            for (auto item : m_scene->items()) {
-                if (auto link = dynamic_cast<Link*>(item)) {
-                    if(link->m_graphId == m_split_link_meta["delete_link"].value<Link*>()->m_graphId) {
-
-                        m_old_graph_ids.push_back(GraphIdChange{
-                            .m_link_id=link->m_id,
-                            .m_old_graph_id=link->m_graphId,
-                            .m_new_graph_id=max_graph_id.value()
-                        });  
-            
-                    }
-                }
-            }
+        if(m_split_link) {
+            Link* new_link_a = m_split_link->m_new_link_a;
+            Link* new_link_b = m_split_link->m_new_link_b;
+            m_graph_id_changes.add(new_link_a->m_id, new_link_a->m_graphId, graph_id);
+            m_graph_id_changes.add(new_link_b->m_id, new_link_b->m_graphId, graph_id);
         }
+    }
+        
+}
 
+size_t AddTrack::memoryUsage() const {
+    return m_graph_id_changes.memoryUsage();
+}
 
-        /*
-        for item in self.scene.items():
-        if isinstance(item, Link) and hasattr(item, 'graph_id') and item.graph_id == self.splitLinkMeta["delete_link"].graph_id:
-            self.new_graph_ids.append({"link_id": item.id, "new_graph_id": max_graph_id})
-            self.old_graph_ids.append({"link_id": item.id, "old_graph_id": item.graph_id})
-*/
-
-        // qDebug() << "##########################################";
-        // print the content of m_new_graph_ids
-        // for (const auto& item : m_new_graph_ids) {
-        //    qDebug() << "link_id =" << item.m_link_id << " old_graph_id =" << item.m_old_graph_id << " new_graph_id =" << item.m_new_graph_id;
-        //}
+void AddTrack::compact() {
+    m_graph_id_changes.compact();
+}
 
-    }
-        
-}
\ No newline at end of file
+void AddTrack::spill(UndoSpillFile* file) {
+    m_graph_id_changes.spill(file);
+}
@@ -4,13 +4,14 @@
 #include <QUndoCommand>
 #include <QGraphicsScene>
 #include <QPointF>
-#include <map>
-#include <vector>
+#include <optional>
 #include "../Link.h"
 #include "../Node.h"
 #include "../ZoomableGraphicsView.h"
 #include "../Editor.h"
 #include "../enums.h"
+#include "GraphIdChanges.h"
+#include "IPagedCommand.h"
 
 struct TrackCreationMeta {
     std::optional<int> m_from_node_id;
@@ -20,13 +21,16 @@ struct TrackCreationMeta {
     LinkSide m_side;
 };
 
-struct GraphIdChange {
-    int m_link_id;
-    int m_old_graph_id;
-    int m_new_graph_id;
+// The clicked link is replaced by two links that meet at the new TO node
+struct SplitLinkMeta {
+    Link* m_new_link_a;
+    Link* m_new_link_b;
+    Link* m_delete_link;
+    Node* m_target_link_from_node = nullptr;
+    Node* m_target_link_to_node = nullptr;
 };
 
-class AddTrack : public QUndoCommand {
+class AddTrack : public QUndoCommand, public IPagedCommand {
 public:
     AddTrack(const TrackCreationMeta& meta);
     ~AddTrack();
@@ -34,6 +38,10 @@ public:
     void undo() override;
     void redo() override;
 
+    size_t memoryUsage() const override;
+    void compact() override;
+    void spill(UndoSpillFile* file) override;
+
     Node* m_from_node;
     Node* m_to_node;
 
@@ -42,14 +50,11 @@ private:
 
     bool m_created_from_node;
     bool m_created_to_node;
-    bool m_created_split_link;
     QGraphicsScene* m_scene;
     //QGraphicsScene* m_graphics_scene;
     TrackCreationMeta m_meta;
-    std::map<QString, QVariant> m_split_link_meta;
-    bool m_is_split_link;
-    std::vector<GraphIdChange> m_old_graph_ids;
-    std::vector<GraphIdChange> m_new_graph_ids;
+    std::optional<SplitLinkMeta> m_split_link;
+    GraphIdChanges m_graph_id_changes;
 
     int m_link_id;
     Link* m_link;
@@ -4,7 +4,6 @@
 #include "../Node.h"
 #include "../ZoomableGraphicsView.h"
 #include "../Link.h"
-#include "AddTrack.h" // GraphIdChange
 #include "../Component.h"
 
 DeleteTrack::DeleteTrack(ZoomableGraphicsView* scene, const DeleteTrackMeta& meta)
@@ -14,12 +13,13 @@ DeleteTrack::DeleteTrack(ZoomableGraphicsView* scene, const DeleteTrackMeta& met
     m_fromNode = m_link->fromNode();
     m_toNode = m_link->toNode();
 
-    m_splitAnalysis = checkGraphSplit();
+    // only the links of the split-off part are kept, as graph id changes
+    std::tuple<bool, std::vector<Link*>> splitAnalysis = checkGraphSplit();
 
-    m_deleteToNode = (m_link->toNode()->getGrade() == 1) && (dynamic_cast<Pad*>(m_link->toNode()) == nullptr);
-    m_deleteFromNode = (m_link->fromNode()->getGrade() == 1) && (dynamic_cast<Pad*>(m_link->fromNode()) == nullptr);
+    m_deleteToNode = (m_link->toNode()->getGrade() == 1) && (m_link->toNode()->type() != Pad::Type);
+    m_deleteFromNode = (m_link->fromNode()->getGrade() == 1) && (m_link->fromNode()->type() != Pad::Type);
 
-    calculateGraphIds();
+    calculateGraphIds(splitAnalysis);
 }
 
 void DeleteTrack::undo() {
@@ -37,13 +37,13 @@ void DeleteTrack::undo() {
     m_fromNode->notifyLinkChanges();
     m_toNode->notifyLinkChanges();
 
-    for (const auto& change : m_graphIdChanges) {
+    m_graphIdChanges.forEach([this](const GraphIdChange& change) {
         Link* linkToChange = m_editor->findItemByIdAndClass<Link>(change.m_link_id);
         if (linkToChange) {
             linkToChange->setGraphId(change.m_old_graph_id);
             linkToChange->updateTextItem(QString::number(change.m_old_graph_id));
         }
-    }
+    });
 }
 
 void DeleteTrack::redo() {
@@ -62,100 +62,86 @@ void DeleteTrack::redo() {
         m_fromNode->notifyLinkChanges();
     }
 
-    for (const auto& change : m_graphIdChanges) {
+    m_graphIdChanges.forEach([this](const GraphIdChange& change) {
         Link* linkToChange = m_editor->findItemByIdAndClass<Link>(change.m_link_id);
         if (linkToChange) {
             linkToChange->setGraphId(change.m_new_graph_id);
             linkToChange->updateTextItem(QString::number(change.m_new_graph_id));
         }
-    }
+    });
     m_link->remove();
 
 }
 
-std::tuple<bool, std::vector<Link*>, std::optional<std::vector<Link*>>> DeleteTrack::checkGraphSplit() {
-    auto [visitedNodes, visitedLinks] = bfs(m_fromNode, m_link->m_id);
-
-    bool isSplit = visitedNodes.find(m_toNode) == visitedNodes.end();
-    std::vector<Link*> graph;
-    std::vector<Link*> graph1;
-
-    for (Link* link : visitedLinks) {
-        if (link->m_id != m_link->m_id) {
-            graph1.push_back(link);
-        }
-    }
-
-    if (isSplit) {
-        std::vector<Link*> splitItems;
-        for (auto item : m_scene->items()) {
-            if (auto link = dynamic_cast<Link*>(item)) {
-                if (link->m_graphId == m_link->m_graphId && link->m_id != m_link->m_id) {
-                    splitItems.push_back(link);
+std::tuple<bool, std::vector<Link*>> DeleteTrack::checkGraphSplit() {
+    // Search from both ends of the deleted link at the same pace. If the searches meet,
+    // the net stays connected. If one of them runs out of nodes first, the net splits
+    // and that side is the smaller one, so only its links get a new graph id.
+    struct Search {
+        std::queue<Node*> queue;
+        std::unordered_set<Node*> visitedNodes;
+        std::unordered_set<Link*> visitedLinks;
+    };
+
+    Search searches[2];
+    searches[0].queue.push(m_fromNode);
+    searches[0].visitedNodes.insert(m_fromNode);
+    searches[1].queue.push(m_toNode);
+    searches[1].visitedNodes.insert(m_toNode);
+
+    while (true) {
+        for (int i = 0; i < 2; ++i) {
+            Search& search = searches[i];
+            Search& other = searches[1 - i];
+
+            if (search.queue.empty()) {
+                // both sides must keep at least one link for the net to be really split
+                bool isSplit = !search.visitedLinks.empty() && !other.visitedLinks.empty();
+                if (!isSplit) {
+                    return {false, {}};
                 }
+                return {true, std::vector<Link*>(search.visitedLinks.begin(), search.visitedLinks.end())};
             }
-        }
-
-        std::vector<Link*> graph2;
-        std::set_difference(splitItems.begin(), splitItems.end(), 
-                            visitedLinks.begin(), visitedLinks.end(),
-                            std::back_inserter(graph2));
-
-        if (graph1.empty()) {
-            isSplit = false;
-            graph = graph2;
-        }
-
-        if (graph2.empty()) {
-            isSplit = false;
-            graph = graph1;
-        }
 
-        if (isSplit) {
-            return {true, graph1, graph2};
-        }
-    } else {
-        graph = std::vector<Link*>(visitedLinks.begin(), visitedLinks.end());
-    }
+            Node* node = search.queue.front();
+            search.queue.pop();
 
-    return {false, graph, std::nullopt};
-}
-
-std::tuple<std::unordered_set<Node*>, std::unordered_set<Link*>> DeleteTrack::bfs(Node* startNode, int ignoreLink) {
-    std::unordered_set<Node*> visitedNodes;
-    std::unordered_set<Link*> visitedLinks;
-    std::queue<Node*> queue;
-
-    queue.push(startNode);
-
-    while (!queue.empty()) {
-        Node* node = queue.front();
-        queue.pop();
-
-        if (visitedNodes.find(node) == visitedNodes.end()) {
-            visitedNodes.insert(node);
-            for (Link* link : node->getLinks()) {
-                if (link->m_id != ignoreLink) {
-                    visitedLinks.insert(link);
-                    Node* nextNode = (link->fromNode() == node) ? link->toNode() : link->fromNode();
-                    if (visitedNodes.find(nextNode) == visitedNodes.end()) {
-                        queue.push(nextNode);
-                    }
+            for (Link* link : node->links()) {
+                if (link->m_id == m_link->m_id) {
+                    continue;
+                }
+                search.visitedLinks.insert(link);
+                Node* nextNode = (link->fromNode() == node) ? link->toNode() : link->fromNode();
+                if (other.visitedNodes.find(nextNode) != other.visitedNodes.end()) {
+                    return {false, {}};
+                }
+                if (search.visitedNodes.insert(nextNode).second) {
+                    search.queue.push(nextNode);
                 }
             }
         }
     }
-
-    return {visitedNodes, visitedLinks};
 }
 
-void DeleteTrack::calculateGraphIds() {
-    auto [isSplit, graph, optionalGraph2] = m_splitAnalysis;
+void DeleteTrack::calculateGraphIds(const std::tuple<bool, std::vector<Link*>>& splitAnalysis) {
+    const auto& [isSplit, graph] = splitAnalysis;
 
     if (isSplit) {
         int newGraphId = TrackGraph::genTrackGraphId();
         for (Link* link : graph) {
-            m_graphIdChanges.push_back({link->m_id, link->m_graphId, newGraphId});
+            m_graphIdChanges.add(link->m_id, link->m_graphId, newGraphId);
         }
     }
 }
+
+size_t DeleteTrack::memoryUsage() const {
+    return m_graphIdChanges.memoryUsage();
+}
+
+void DeleteTrack::compact() {
+    m_graphIdChanges.compact();
+}
+
+void DeleteTrack::spill(UndoSpillFile* file) {
+    m_graphIdChanges.spill(file);
+}
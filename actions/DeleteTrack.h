@@ -6,38 +6,39 @@
 #include <optional>
 #include <unordered_set>
 #include <queue>
+#include "GraphIdChanges.h"
+#include "IPagedCommand.h"
 
 class ZoomableGraphicsView;
 class Link;
 class Node;
 class Editor;
-struct GraphIdChange;
 
 struct DeleteTrackMeta {
     int m_linkId;
 };
 
-class DeleteTrack : public QUndoCommand {
+class DeleteTrack : public QUndoCommand, public IPagedCommand {
 public:
     DeleteTrack(ZoomableGraphicsView* scene, const DeleteTrackMeta& meta);
     void undo() override;
     void redo() override;
 
+    size_t memoryUsage() const override;
+    void compact() override;
+    void spill(UndoSpillFile* file) override;
+
 private:
-    std::tuple<bool, std::vector<Link*>, std::optional<std::vector<Link*>>> checkGraphSplit();
-    std::tuple<std::unordered_set<Node*>, std::unordered_set<Link*>> bfs(Node* startNode, int ignoreLink);
-    void calculateGraphIds();
+    std::tuple<bool, std::vector<Link*>> checkGraphSplit();
+    void calculateGraphIds(const std::tuple<bool, std::vector<Link*>>& splitAnalysis);
 
     Editor* m_editor;
     QGraphicsScene* m_scene;
     DeleteTrackMeta m_meta;
-    std::vector<GraphIdChange> m_graphIdChanges;
+    GraphIdChanges m_graphIdChanges;
     Link* m_link;
     Node* m_fromNode;
     Node* m_toNode;
-    std::tuple<bool, std::vector<Link*>, std::optional<std::vector<Link*>>> m_splitAnalysis;
-    std::vector<Node*> m_nodesToDelete;
-    std::vector<Node*> m_nodesToUpdate;
     bool m_deleteToNode;
     bool m_deleteFromNode;
 };
@@ -0,0 +1,157 @@
+#include "GraphIdChanges.h"
+#include "../UndoHistory.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    // LEB128 varints: small numbers and the gaps between sorted ids take one or two bytes
+    void writeVarint(QByteArray& out, quint32 value) {
+        while (value >= 0x80) {
+            out.append(char((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        out.append(char(value));
+    }
+
+    bool readVarint(const QByteArray& in, int& pos, quint32& value) {
+        value = 0;
+        for (int shift = 0; shift < 35 && pos < in.size(); shift += 7) {
+            quint8 byte = quint8(in[pos++]);
+            value |= quint32(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // zigzag keeps negative ids (-1 for a link without a net) short
+    quint32 zigzag(int value) {
+        return (quint32(value) << 1) ^ quint32(value >> 31);
+    }
+
+    int unzigzag(quint32 value) {
+        return int(value >> 1) ^ -int(value & 1);
+    }
+}
+
+GraphIdChanges::~GraphIdChanges() {
+    if (m_storage == Storage::Spilled) {
+        m_file->release(m_offset, m_size);
+    }
+}
+
+void GraphIdChanges::add(int linkId, int oldGraphId, int newGraphId) {
+    load();
+    auto group = std::find_if(m_groups.rbegin(), m_groups.rend(), [&](const Group& g) {
+        return g.m_old_graph_id == oldGraphId && g.m_new_graph_id == newGraphId;
+    });
+    if (group == m_groups.rend()) {
+        m_groups.push_back(Group{oldGraphId, newGraphId, {}});
+        group = m_groups.rbegin();
+    }
+    group->m_link_ids.push_back(linkId);
+}
+
+size_t GraphIdChanges::memoryUsage() const {
+    size_t usage = m_groups.capacity() * sizeof(Group) + size_t(m_record.capacity());
+    for (const Group& group : m_groups) {
+        usage += group.m_link_ids.capacity() * sizeof(int);
+    }
+    return usage;
+}
+
+void GraphIdChanges::compact() {
+    if (m_storage != Storage::Live || m_groups.empty()) {
+        return;
+    }
+    m_record = encode();
+    std::vector<Group>().swap(m_groups);
+    m_storage = Storage::Compact;
+}
+
+void GraphIdChanges::spill(UndoSpillFile* file) {
+    compact();
+    if (m_storage != Storage::Compact) {
+        return;
+    }
+    qint64 offset = file->write(m_record);
+    if (offset < 0) {
+        return; // the record stays in memory
+    }
+    m_file = file;
+    m_offset = offset;
+    m_size = int(m_record.size());
+    m_record = QByteArray();
+    m_storage = Storage::Spilled;
+}
+
+bool GraphIdChanges::load() {
+    if (m_storage == Storage::Live) {
+        return true;
+    }
+    QByteArray record = m_record;
+    if (m_storage == Storage::Spilled) {
+        // the record is back in memory, its place in the file can be reused
+        record = m_file->read(m_offset, m_size);
+        m_file->release(m_offset, m_size);
+    }
+    bool decoded = decode(record);
+    if (!decoded) {
+        qWarning() << "Undo history record could not be read, the net ids of the command are not restored";
+    }
+    m_record = QByteArray();
+    m_file = nullptr;
+    m_storage = Storage::Live;
+    return decoded;
+}
+
+QByteArray GraphIdChanges::encode() const {
+    QByteArray out;
+    writeVarint(out, quint32(m_groups.size()));
+    for (const Group& group : m_groups) {
+        writeVarint(out, zigzag(group.m_old_graph_id));
+        writeVarint(out, zigzag(group.m_new_graph_id));
+        writeVarint(out, quint32(group.m_link_ids.size()));
+
+        // the order of the changes does not matter, sorted ids are stored as gaps
+        std::vector<int> ids = group.m_link_ids;
+        std::sort(ids.begin(), ids.end());
+        int previous = 0;
+        for (int id : ids) {
+            writeVarint(out, zigzag(id - previous));
+            previous = id;
+        }
+    }
+    return out;
+}
+
+bool GraphIdChanges::decode(const QByteArray& record) {
+    m_groups.clear();
+    int pos = 0;
+    quint32 groupCount = 0;
+    if (!readVarint(record, pos, groupCount)) {
+        return false;
+    }
+    m_groups.reserve(groupCount);
+    for (quint32 g = 0; g < groupCount; ++g) {
+        quint32 oldGraphId, newGraphId, count;
+        if (!readVarint(record, pos, oldGraphId) || !readVarint(record, pos, newGraphId) ||
+            !readVarint(record, pos, count)) {
+            return false;
+        }
+        Group group{unzigzag(oldGraphId), unzigzag(newGraphId), {}};
+        group.m_link_ids.reserve(count);
+        int previous = 0;
+        for (quint32 i = 0; i < count; ++i) {
+            quint32 gap;
+            if (!readVarint(record, pos, gap)) {
+                return false;
+            }
+            previous += unzigzag(gap);
+            group.m_link_ids.push_back(previous);
+        }
+        m_groups.push_back(std::move(group));
+    }
+    return true;
+}
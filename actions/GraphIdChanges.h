@@ -0,0 +1,66 @@
+#pragma once
+
+#include <QByteArray>
+#include <vector>
+
+class UndoSpillFile;
+
+struct GraphIdChange {
+    int m_link_id;
+    int m_old_graph_id;
+    int m_new_graph_id;
+};
+
+// Net ids changed by one undo command. Links moved between the same pair of nets form
+// one group, so merging two nets costs one int per link instead of a GraphIdChange.
+// UndoHistory compacts the changes of old commands to a delta-encoded record and spills
+// records beyond its memory budget to disk; forEach() pages them back in.
+class GraphIdChanges {
+public:
+    enum class Storage { Live, Compact, Spilled };
+
+    GraphIdChanges() = default;
+    GraphIdChanges(const GraphIdChanges&) = delete;
+    GraphIdChanges& operator=(const GraphIdChanges&) = delete;
+    // Frees the place of a spilled record in the spill file
+    ~GraphIdChanges();
+
+    void add(int linkId, int oldGraphId, int newGraphId);
+    bool empty() const { return m_groups.empty() && m_storage == Storage::Live; }
+
+    // Calls f(GraphIdChange) for every change
+    template <typename F>
+    void forEach(F f) {
+        load();
+        for (const Group& group : m_groups) {
+            for (int linkId : group.m_link_ids) {
+                f(GraphIdChange{linkId, group.m_old_graph_id, group.m_new_graph_id});
+            }
+        }
+    }
+
+    Storage storage() const { return m_storage; }
+    // Heap bytes held besides the object itself
+    size_t memoryUsage() const;
+
+    void compact();
+    void spill(UndoSpillFile* file);
+    bool load();
+
+private:
+    struct Group {
+        int m_old_graph_id;
+        int m_new_graph_id;
+        std::vector<int> m_link_ids;
+    };
+
+    QByteArray encode() const;
+    bool decode(const QByteArray& record);
+
+    std::vector<Group> m_groups;
+    Storage m_storage = Storage::Live;
+    QByteArray m_record;            // Compact: the encoded groups
+    UndoSpillFile* m_file = nullptr; // Spilled: where the record is
+    qint64 m_offset = 0;
+    int m_size = 0;
+};
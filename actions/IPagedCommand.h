@@ -0,0 +1,23 @@
+#ifndef IPAGED_COMMAND_H
+#define IPAGED_COMMAND_H
+
+#include <cstddef>
+
+class UndoSpillFile;
+
+// Undo command whose history records UndoHistory can shrink once the command is old.
+// The command pages its records back in by itself in undo()/redo(). Scene items owned
+// by the command are not records: they are neither counted nor paged.
+class IPagedCommand {
+public:
+    virtual ~IPagedCommand() = default;
+
+    // Estimated bytes held by the records of the command
+    virtual size_t memoryUsage() const = 0;
+    // Keep the data as a compact record in memory
+    virtual void compact() = 0;
+    // Move the record to the spill file
+    virtual void spill(UndoSpillFile* file) = 0;
+};
+
+#endif // IPAGED_COMMAND_H
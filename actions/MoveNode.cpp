@@ -1,24 +1,90 @@
 #include "MoveNode.h"
 #include "../Editor.h"
+#include "../Link.h"
 #include <QVariantMap>
+#include <algorithm>
 
 MoveNode::MoveNode(const MoveNodeMeta& meta)
     : QUndoCommand()
-    , m_meta(meta)
+    , m_applied(true)
 {
-    m_node = Editor::instance()->findItemByIdAndClass<Node>(m_meta.nodeId);
+    add(meta);
+}
+
+MoveNode::MoveNode(const std::vector<MoveNodeMeta>& moves)
+    : QUndoCommand()
+    , m_applied(false)
+{
+    m_nodeIds.reserve(moves.size());
+    m_offsets.reserve(moves.size());
+    for (const MoveNodeMeta& meta : moves) {
+        add(meta);
+    }
+}
+
+void MoveNode::add(const MoveNodeMeta& meta)
+{
+    QPointF offset = meta.targetPosition - meta.sourcePosition;
+    if (offset.isNull()) {
+        return;
+    }
+    m_nodeIds.push_back(meta.nodeId);
+    m_offsets.push_back(offset);
 }
 
 void MoveNode::undo()
 {
-    m_node->setPos(m_meta.sourcePosition);
-    m_node->updateLinks();
+    apply(-1);
 }
 
 void MoveNode::redo()
 {
-    m_node->setPos(m_meta.targetPosition);
-    m_node->updateLinks();
+    // the dragged nodes are already in place, only their links need to follow
+    apply(m_applied ? 0 : 1);
+    m_applied = false;
+}
+
+bool MoveNode::mergeWith(const QUndoCommand* other)
+{
+    // only moves of the same nodes merge, e.g. dragging one node several times in a row
+    const MoveNode* move = static_cast<const MoveNode*>(other);
+    if (move->m_nodeIds != m_nodeIds) {
+        return false;
+    }
+
+    bool moved = false;
+    for (size_t i = 0; i < m_offsets.size(); ++i) {
+        m_offsets[i] += move->m_offsets[i];
+        moved = moved || !m_offsets[i].isNull();
+    }
+    // nodes dragged back to where they started leave nothing to undo
+    setObsolete(!moved);
+    return true;
+}
+
+void MoveNode::apply(qreal direction)
+{
+    Editor* editor = Editor::instance();
+    std::vector<Link*> links;
+    for (size_t i = 0; i < m_nodeIds.size(); ++i) {
+        Node* node = editor->findItemByIdAndClass<Node>(m_nodeIds[i]);
+        if (!node) {
+            continue;
+        }
+        if (direction != 0) {
+            node->setPos(node->pos() + direction * m_offsets[i]);
+        }
+        for (Link* link : node->links()) {
+            links.push_back(link);
+        }
+    }
+
+    // a link between two moved nodes is redrawn once
+    std::sort(links.begin(), links.end());
+    links.erase(std::unique(links.begin(), links.end()), links.end());
+    for (Link* link : links) {
+        link->trackNodes();
+    }
 }
 
 /*
@@ -30,4 +96,4 @@ QVariantMap MoveNode::toDict() const
     dict["targetPosition"] = m_meta.targetPosition;
     return dict;
 }
-    */
\ No newline at end of file
+    */
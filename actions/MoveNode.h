@@ -2,6 +2,7 @@
 
 #include <QUndoCommand>
 #include <QPointF>
+#include <vector>
 #include "../Node.h"
 
 struct MoveNodeMeta {
@@ -10,16 +11,31 @@ struct MoveNodeMeta {
     QPointF targetPosition;
 };
 
+// Moves one or more nodes as a single undo step. Each node is stored as its id and
+// the offset of the move, so repeated moves of the same nodes merge into one command.
 class MoveNode : public QUndoCommand {
 public:
+    enum { Id = 1 };
+
+    // A node dragged with the mouse is already at its target when the command is pushed
     MoveNode(const MoveNodeMeta& meta);
 
+    // Batch of moves, applied by the first redo(); each node may appear only once
+    MoveNode(const std::vector<MoveNodeMeta>& moves);
+
     void undo() override;
     void redo() override;
 
+    int id() const override { return Id; }
+    bool mergeWith(const QUndoCommand* other) override;
+
     QVariantMap toDict() const;
 
 private:
-    MoveNodeMeta m_meta;
-    Node* m_node;
-};
\ No newline at end of file
+    void add(const MoveNodeMeta& meta);
+    void apply(qreal direction);
+
+    std::vector<int> m_nodeIds;
+    std::vector<QPointF> m_offsets;
+    bool m_applied;
+};
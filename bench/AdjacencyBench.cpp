@@ -0,0 +1,136 @@
+#include "Benchmarks.h"
+#include "Adjacency.h"
+#include <memory>
+#include <queue>
+#include <unordered_set>
+#include <vector>
+
+namespace
+{
+    struct BenchLink;
+
+    // Узел и связь с теми же списками смежности, что у Node и Link, но без графических элементов
+    struct BenchNode
+    {
+        AdjacencyList<BenchLink> links;
+
+        // Копия списка, как прежний Node::getLinks()
+        std::vector<BenchLink *> linksCopy() const
+        {
+            return std::vector<BenchLink *>(links.begin(), links.end());
+        }
+    };
+
+    struct BenchLink
+    {
+        BenchNode *from = nullptr;
+        BenchNode *to = nullptr;
+        mutable AdjacencySlots<2> slots;
+
+        AdjacencySlots<2> &adjacencySlots() const { return slots; }
+    };
+
+    // Обход в ширину как в DeleteTrack::checkGraphSplit, возвращает число посещенных связей
+    template <typename LinksOf>
+    size_t bfs(BenchNode *start, LinksOf linksOf)
+    {
+        std::queue<BenchNode *> queue;
+        std::unordered_set<BenchNode *> visitedNodes;
+        std::unordered_set<BenchLink *> visitedLinks;
+        queue.push(start);
+        visitedNodes.insert(start);
+        while (!queue.empty())
+        {
+            BenchNode *node = queue.front();
+            queue.pop();
+            for (BenchLink *link : linksOf(node))
+            {
+                visitedLinks.insert(link);
+                BenchNode *next = link->from == node ? link->to : link->from;
+                if (visitedNodes.insert(next).second)
+                {
+                    queue.push(next);
+                }
+            }
+        }
+        return visitedLinks.size();
+    }
+}
+
+/*
+ * Функция benchAdjacency - обход в ширину цепи из 100k связей
+ *
+ * Цепь - квадратная решетка 224 x 224 узла (99904 связи), обход начинается из угла.
+ * Сравнивается обход с копированием списка связей узла и без копирования.
+ * Входные параметры:
+ *   report - набор результатов
+ * Выходные данные:
+ *   отсутствуют
+ */
+void benchAdjacency(BenchReport &report)
+{
+    constexpr int Side = 224;
+
+    std::vector<std::unique_ptr<BenchNode>> nodes;
+    nodes.reserve(Side * Side);
+    for (int i = 0; i < Side * Side; ++i)
+    {
+        nodes.push_back(std::make_unique<BenchNode>());
+    }
+
+    std::vector<std::unique_ptr<BenchLink>> links;
+    auto connect = [&links](BenchNode *from, BenchNode *to)
+    {
+        auto link = std::make_unique<BenchLink>();
+        link->from = from;
+        link->to = to;
+        from->links.add(link.get());
+        to->links.add(link.get());
+        links.push_back(std::move(link));
+    };
+
+    BenchTimer timer;
+    timer.start();
+    for (int y = 0; y < Side; ++y)
+    {
+        for (int x = 0; x < Side; ++x)
+        {
+            BenchNode *node = nodes[y * Side + x].get();
+            if (x + 1 < Side)
+                connect(node, nodes[y * Side + x + 1].get());
+            if (y + 1 < Side)
+                connect(node, nodes[(y + 1) * Side + x].get());
+        }
+    }
+    BenchSample build = timer.sample();
+
+    timer.restart();
+    size_t copied = bfs(nodes.front().get(), [](BenchNode *node)
+                        { return node->linksCopy(); });
+    BenchSample copy = timer.sample();
+
+    timer.restart();
+    size_t spanned = bfs(nodes.front().get(), [](BenchNode *node)
+                         { return node->links.items(); });
+    BenchSample span = timer.sample();
+
+    // отключение и повторное подключение каждой связи
+    timer.restart();
+    for (const auto &link : links)
+    {
+        link->from->links.remove(link.get());
+        link->to->links.remove(link.get());
+        link->from->links.add(link.get());
+        link->to->links.add(link.get());
+    }
+    BenchSample churn = timer.sample();
+
+    // Списки узлов освобождают позиции связей, поэтому узлы удаляются раньше связей
+    nodes.clear();
+
+    const double linkCount = double(links.size());
+    report.add("adjacency/build", 1, build, {{"links", linkCount}});
+    report.add("adjacency/bfs_copy", 1, copy, {{"links", double(copied)}});
+    report.add("adjacency/bfs_span", 1, span, {{"links", double(spanned)}});
+    report.add("adjacency/remove_add", qint64(links.size()), churn);
+}
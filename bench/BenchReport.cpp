@@ -0,0 +1,118 @@
+#include "BenchReport.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSysInfo>
+#include <QThread>
+#include <QTextStream>
+#include <algorithm>
+
+namespace
+{
+// Время на один повтор, нс
+double perIteration(qint64 totalNs, qint64 iterations)
+{
+    return double(totalNs) / std::max<qint64>(iterations, 1);
+}
+}
+
+/*
+ * Функция BenchReport::add - добавление результата
+ * Входные параметры:
+ *   name - имя бенчмарка
+ *   iterations - число повторов операции, вошедших в total
+ *   total - время всех повторов
+ *   counters - дополнительные величины
+ * Выходные данные:
+ *   отсутствуют
+ */
+void BenchReport::add(const QString &name, qint64 iterations, const BenchSample &total,
+                      const QMap<QString, double> &counters)
+{
+    m_results.push_back({name, iterations, total, counters});
+}
+
+/*
+ * Функция BenchReport::toJson - отчет в формате Google Benchmark
+ *
+ * Дополнительные величины записываются полями результата, как пользовательские
+ * счетчики Google Benchmark.
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   QByteArray - документ JSON
+ */
+QByteArray BenchReport::toJson() const
+{
+    QJsonObject context;
+    context["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    context["host_name"] = QSysInfo::machineHostName();
+    context["executable"] = QCoreApplication::applicationFilePath();
+    context["num_cpus"] = QThread::idealThreadCount();
+    context["qt_version"] = QString(qVersion());
+#ifdef NDEBUG
+    context["library_build_type"] = "release";
+#else
+    context["library_build_type"] = "debug";
+#endif
+
+    QJsonArray benchmarks;
+    for (const BenchResult &result : m_results)
+    {
+        QJsonObject entry;
+        entry["name"] = result.name;
+        entry["run_name"] = result.name;
+        entry["run_type"] = "iteration";
+        entry["repetitions"] = 1;
+        entry["repetition_index"] = 0;
+        entry["threads"] = 1;
+        entry["iterations"] = result.iterations;
+        entry["real_time"] = perIteration(result.total.realNs, result.iterations);
+        entry["cpu_time"] = perIteration(result.total.cpuNs, result.iterations);
+        entry["time_unit"] = "ns";
+        for (auto it = result.counters.begin(); it != result.counters.end(); ++it)
+        {
+            entry[it.key()] = it.value();
+        }
+        benchmarks.append(entry);
+    }
+
+    QJsonObject root;
+    root["context"] = context;
+    root["benchmarks"] = benchmarks;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+/*
+ * Функция BenchReport::toText - текстовая таблица результатов
+ * Входные параметры:
+ *   отсутствуют
+ * Выходные данные:
+ *   QString - текст отчета
+ */
+QString BenchReport::toText() const
+{
+    int nameWidth = 0;
+    for (const BenchResult &result : m_results)
+    {
+        nameWidth = std::max(nameWidth, int(result.name.size()));
+    }
+
+    QString text;
+    QTextStream out(&text);
+    for (const BenchResult &result : m_results)
+    {
+        out << result.name.leftJustified(nameWidth + 2)
+            << QString::number(perIteration(result.total.realNs, result.iterations), 'f', 1).rightJustified(16) << " ns"
+            << QString::number(perIteration(result.total.cpuNs, result.iterations), 'f', 1).rightJustified(16) << " ns cpu"
+            << QString::number(result.iterations).rightJustified(10);
+        for (auto it = result.counters.begin(); it != result.counters.end(); ++it)
+        {
+            out << "  " << it.key() << "=" << it.value();
+        }
+        out << "\n";
+    }
+    return text;
+}
@@ -0,0 +1,108 @@
+#ifndef BENCHREPORT_H
+#define BENCHREPORT_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QString>
+#include <ctime>
+#include <vector>
+
+/**
+ * @brief Затраченное время: по настенным часам и процессорное время процесса
+ */
+struct BenchSample
+{
+    qint64 realNs = 0; ///< Время по настенным часам, нс
+    qint64 cpuNs = 0;  ///< Процессорное время процесса, нс
+};
+
+/**
+ * @brief Таймер бенчмарка: замена QElapsedTimer, дополнительно считающая процессорное время
+ */
+class BenchTimer
+{
+public:
+    /**
+     * @brief Запускает таймер заново
+     */
+    void start()
+    {
+        m_cpuStart = std::clock();
+        m_timer.start();
+    }
+
+    void restart() { start(); }
+
+    /**
+     * @brief Возвращает время, прошедшее с последнего start()
+     * @return Время по настенным часам и процессорное время
+     */
+    BenchSample sample() const
+    {
+        BenchSample sample;
+        sample.realNs = m_timer.nsecsElapsed();
+        sample.cpuNs = qint64(double(std::clock() - m_cpuStart) * 1e9 / CLOCKS_PER_SEC);
+        return sample;
+    }
+
+private:
+    QElapsedTimer m_timer;
+    std::clock_t m_cpuStart = 0;
+};
+
+/**
+ * @brief Результат одного бенчмарка
+ */
+struct BenchResult
+{
+    QString name;                    ///< Имя вида "группа/операция[/масштаб]"
+    qint64 iterations;               ///< Число повторов операции за замер
+    BenchSample total;               ///< Время всех повторов
+    QMap<QString, double> counters;  ///< Дополнительные величины (размер платы, число попаданий и т.п.)
+};
+
+/**
+ * @brief Набор результатов pcb-tracer-bench
+ *
+ * JSON повторяет формат Google Benchmark (--benchmark_format=json): объект "context"
+ * и массив "benchmarks" с real_time и cpu_time на один повтор в наносекундах.
+ * Поэтому результаты двух версий можно сравнить tools/compare.py из Google Benchmark.
+ *
+ * Основные функции:
+ * 1. add(name, iterations, total, counters) - добавление результата
+ * 2. toJson() - отчет в формате Google Benchmark
+ * 3. toText() - таблица для чтения в терминале
+ */
+class BenchReport
+{
+public:
+    /**
+     * @brief Добавляет результат
+     * @param name Имя бенчмарка
+     * @param iterations Число повторов операции, вошедших в total
+     * @param total Время всех повторов
+     * @param counters Дополнительные величины
+     */
+    void add(const QString &name, qint64 iterations, const BenchSample &total,
+             const QMap<QString, double> &counters = {});
+
+    const std::vector<BenchResult> &results() const { return m_results; }
+
+    /**
+     * @brief Формирует отчет в формате Google Benchmark
+     * @return Документ JSON
+     */
+    QByteArray toJson() const;
+
+    /**
+     * @brief Формирует текстовую таблицу: имя, время на повтор, число повторов, величины
+     * @return Текст отчета
+     */
+    QString toText() const;
+
+private:
+    std::vector<BenchResult> m_results; ///< Результаты в порядке добавления
+};
+
+#endif // BENCHREPORT_H
@@ -0,0 +1,23 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include "BenchReport.h"
+
+struct BoardSpec;
+
+/*
+ * Бенчмарки pcb-tracer-bench
+ *
+ * Каждый бенчмарк добавляет свои замеры в report (см. BenchReport).
+ *
+ * 1. benchNodeIndex(BenchReport& report) - поиск ближайшего узла в индексе из 1M узлов
+ * 2. benchAdjacency(BenchReport& report) - обход в ширину цепи из 100k связей
+ * 3. benchItemCast(BenchReport& report) - определение типа 1M элементов сцены (dynamic_cast и item_cast)
+ * 4. benchEditor(BenchReport& report, const BoardSpec& spec) - операции редактора на синтетической плате
+ */
+void benchNodeIndex(BenchReport &report);
+void benchAdjacency(BenchReport &report);
+void benchItemCast(BenchReport &report);
+void benchEditor(BenchReport &report, const BoardSpec &spec);
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,116 @@
+#include "BoardGenerator.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace
+{
+constexpr qreal ComponentPitch = 400; ///< Шаг сетки компонентов
+constexpr qreal PadPitch = 30;        ///< Шаг контактов в ряду
+constexpr qreal RowOffset = 40;       ///< Расстояние ряда контактов от центра компонента
+constexpr qreal NodeJitter = 10;      ///< Разброс промежуточных узлов относительно прямой
+}
+
+/*
+ * Функция generateBoard - создание снимка синтетической платы
+ *
+ * Число промежуточных узлов на дорожку подбирается так, чтобы в среднем
+ * получилось spec.tracks связей: при средней цепи из 3 контактов на 3 контакта
+ * приходится 2 дорожки.
+ * Входные параметры:
+ *   spec - параметры платы
+ * Выходные данные:
+ *   SceneSnapshot - снимок платы
+ */
+SceneSnapshot generateBoard(const BoardSpec &spec)
+{
+    SceneSnapshot snapshot;
+    std::mt19937 random(spec.seed);
+
+    int lastNodeId = 0;
+    int lastLinkId = 0;
+    int lastGraphId = 0;
+
+    // Компоненты сеткой, контакты в два ряда
+    const int columns = std::max(1, int(std::ceil(std::sqrt(double(spec.components)))));
+    const int perRow = (spec.padsPerComponent + 1) / 2;
+    std::vector<const PadRecord *> pads;
+    snapshot.components.reserve(spec.components);
+    for (int c = 0; c < spec.components; ++c)
+    {
+        ComponentRecord component;
+        component.id = c + 1;
+        component.name = QString("U%1").arg(component.id);
+        component.x = (c % columns) * ComponentPitch;
+        component.y = (c / columns) * ComponentPitch;
+        component.pads.reserve(spec.padsPerComponent);
+        for (int p = 0; p < spec.padsPerComponent; ++p)
+        {
+            const int row = p / perRow;
+            const int column = row == 0 ? p : spec.padsPerComponent - 1 - p; // нумерация против часовой стрелки
+            PadRecord pad;
+            pad.id = ++lastNodeId;
+            pad.number = p + 1;
+            pad.name = QString("%1 Pin %2").arg(component.name).arg(pad.number);
+            pad.x = component.x + (column - perRow / 2.0) * PadPitch;
+            pad.y = component.y + (row == 0 ? -RowOffset : RowOffset);
+            component.pads.push_back(pad);
+        }
+        snapshot.components.push_back(std::move(component));
+    }
+    for (const ComponentRecord &component : snapshot.components)
+    {
+        for (const PadRecord &pad : component.pads)
+        {
+            pads.push_back(&pad);
+        }
+    }
+    std::shuffle(pads.begin(), pads.end(), random);
+
+    // Среднее число связей на дорожку
+    const double expectedTracks = std::max(1.0, pads.size() * 2.0 / 3.0);
+    const double averageSegments = std::max(1.0, spec.tracks / expectedTracks);
+    std::uniform_int_distribution<int> netSize(2, 4);
+    std::uniform_int_distribution<int> segments(1, std::max(1, int(std::lround(2 * averageSegments - 1))));
+    std::uniform_int_distribution<int> side(0, 1);
+    std::uniform_real_distribution<qreal> jitter(-NodeJitter, NodeJitter);
+
+    snapshot.links.reserve(spec.tracks);
+    size_t next = 0;
+    while (int(snapshot.links.size()) < spec.tracks && next + 1 < pads.size())
+    {
+        const size_t count = std::min<size_t>(netSize(random), pads.size() - next);
+        const int graphId = ++lastGraphId;
+        for (size_t i = next + 1; i < next + count && int(snapshot.links.size()) < spec.tracks; ++i)
+        {
+            const PadRecord *from = pads[i - 1];
+            const PadRecord *to = pads[i];
+            const LinkSide trackSide = side(random) ? LinkSide::BACK : LinkSide::FRONT;
+            const int segmentCount = segments(random);
+
+            // Дорожка от контакта к контакту через segmentCount - 1 промежуточных узлов
+            int fromId = from->id;
+            for (int s = 1; s <= segmentCount; ++s)
+            {
+                int toId = to->id;
+                if (s < segmentCount)
+                {
+                    const qreal t = qreal(s) / segmentCount;
+                    toId = ++lastNodeId;
+                    snapshot.nodes.push_back({toId, from->x + t * (to->x - from->x) + jitter(random),
+                                              from->y + t * (to->y - from->y) + jitter(random)});
+                }
+                snapshot.links.push_back({++lastLinkId, fromId, toId, graphId, trackSide, std::nullopt});
+                fromId = toId;
+            }
+        }
+        next += count;
+    }
+
+    snapshot.lastComponentId = spec.components;
+    snapshot.lastNodeId = lastNodeId;
+    snapshot.lastLinkId = lastLinkId;
+    snapshot.lastNoteId = 0;
+    snapshot.trackGraphCount = lastGraphId;
+    return snapshot;
+}
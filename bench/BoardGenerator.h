@@ -0,0 +1,34 @@
+#ifndef BOARDGENERATOR_H
+#define BOARDGENERATOR_H
+
+#include <QString>
+#include "SceneSnapshot.h"
+
+/**
+ * @brief Параметры синтетической платы
+ */
+struct BoardSpec
+{
+    QString name;         ///< Имя масштаба в именах бенчмарков
+    int components;       ///< Число компонентов
+    int padsPerComponent; ///< Контактов на компонент
+    int tracks;           ///< Желаемое число связей
+    quint32 seed = 1;     ///< Начальное значение генератора случайных чисел
+};
+
+/**
+ * @brief Создает снимок синтетической платы для бенчмарков
+ *
+ * Компоненты расставлены сеткой, контакты - в два ряда по краям корпуса.
+ * Контакты перемешиваются и разбираются в цепи по 2-4 контакта; соседние контакты
+ * цепи соединяются дорожкой через промежуточные узлы, сторона (FRONT или BACK)
+ * выбирается случайно для каждой дорожки. Каждый контакт входит не более чем в одну цепь,
+ * поэтому ID цепей в снимке согласованы со связностью.
+ * Генерация прекращается, когда набрано tracks связей или закончились контакты.
+ * Одинаковые параметры дают одинаковую плату.
+ * @param spec Параметры платы
+ * @return Снимок, готовый для SceneSnapshot::restore() и загрузчиков
+ */
+SceneSnapshot generateBoard(const BoardSpec &spec);
+
+#endif // BOARDGENERATOR_H
@@ -0,0 +1,285 @@
+#include "Benchmarks.h"
+#include "BoardGenerator.h"
+#include "ColorBox.h"
+#include "Config.h"
+#include "ConnectionAnalyzer.h"
+#include "Editor.h"
+#include "SceneLoader.h"
+#include "SceneLoaderBinary.h"
+#include "actions/AddTrack.h"
+#include "actions/DeleteTrack.h"
+#include "actions/MoveNode.h"
+#include <QTemporaryDir>
+#include <QDebug>
+#include <algorithm>
+#include <memory>
+#include <random>
+
+namespace
+{
+constexpr int MaxOperations = 1000; ///< Наибольшее число команд AddTrack/DeleteTrack на масштаб
+constexpr int ApplyRepeats = 5;     ///< Повторы Config::apply
+constexpr int NetlistRepeats = 5;   ///< Повторы ConnectionAnalyzer::netlist
+
+// Редактор без главного окна: панель цветов нужна Config::apply, строки состояния нет
+Editor *benchEditorInstance()
+{
+    static Editor *editor = nullptr;
+    if (!editor)
+    {
+        editor = Editor::instance();
+        editor->m_colorBox = new ColorBox();
+        editor->setStatusBar(nullptr);
+    }
+    return editor;
+}
+
+// Пары узлов из разных цепей исходной платы: новая дорожка между ними сливает две цепи
+std::vector<TrackCreationMeta> pickMergingTracks(const SceneSnapshot &board, int count, std::mt19937 &random)
+{
+    std::vector<TrackCreationMeta> tracks;
+    if (board.links.size() < 2)
+    {
+        return tracks;
+    }
+    Editor *editor = benchEditorInstance();
+    std::uniform_int_distribution<size_t> pick(0, board.links.size() - 1);
+    // На плате из одной цепи подходящих пар нет, поэтому число попыток ограничено
+    for (int attempt = 0; int(tracks.size()) < count && attempt < 100 * count; ++attempt)
+    {
+        const LinkRecord &from = board.links[pick(random)];
+        const LinkRecord &to = board.links[pick(random)];
+        if (from.graphId == to.graphId)
+        {
+            continue;
+        }
+        Node *fromNode = editor->findItemByIdAndClass<Node>(from.fromNodeId);
+        Node *toNode = editor->findItemByIdAndClass<Node>(to.toNodeId);
+        LinkSide side = tracks.size() % 2 ? LinkSide::BACK : LinkSide::FRONT;
+        tracks.push_back({fromNode->m_id, fromNode->pos(), toNode->pos(), toNode, side});
+    }
+    return tracks;
+}
+
+// Величины замера с временем, приведенным к 100k связей платы, для сравнения масштабов
+QMap<QString, double> per100kLinks(const QMap<QString, double> &size, const BenchSample &sample)
+{
+    QMap<QString, double> counters = size;
+    const double links = std::max(1.0, size.value("links"));
+    counters["ms_per_100k_links"] = double(sample.realNs) / 1e6 * 100000.0 / links;
+    return counters;
+}
+
+// Отмена и повтор всех команд стека с записью времени каждого прохода
+void benchUndoRedo(BenchReport &report, const QString &group, const QString &suffix, int count,
+                   const QMap<QString, double> &size)
+{
+    QUndoStack &stack = benchEditorInstance()->m_undoStack;
+    BenchTimer timer;
+
+    timer.start();
+    for (int i = 0; i < count; ++i)
+    {
+        stack.undo();
+    }
+    report.add(group + "/undo" + suffix, count, timer.sample(), size);
+
+    timer.restart();
+    for (int i = 0; i < count; ++i)
+    {
+        stack.redo();
+    }
+    report.add(group + "/redo" + suffix, count, timer.sample(), size);
+
+    // Плата возвращается в исходное состояние для следующих замеров
+    for (int i = 0; i < count; ++i)
+    {
+        stack.undo();
+    }
+    stack.clear();
+}
+}
+
+/*
+ * Функция benchEditor - операции редактора на синтетической плате
+ *
+ * Плата из generateBoard(spec) восстанавливается на сцене редактора, затем измеряются:
+ * восстановление сцены, Config::apply, построение списка соединений
+ * (расчетная часть ConnectionAnalyzer::getConnections, без диалога),
+ * AddTrack (конструктор с calculateGraphIds, push, undo, redo) для дорожек,
+ * сливающих две цепи, DeleteTrack (push, undo, redo) для случайных связей,
+ * MoveNode для тех же перемещений узлов по одному и одной пакетной командой,
+ * снимок сцены, запись и чтение JSON и бинарного формата (версий 1 и 2).
+ * Снимок и бинарные запись и чтение дополнительно приводятся к 100k связей
+ * (величина ms_per_100k_links).
+ *
+ * Editor::clean() только убирает элементы со сцены, поэтому память каждого
+ * масштаба остается занятой до конца процесса.
+ * Входные параметры:
+ *   report - набор результатов
+ *   spec - параметры платы
+ * Выходные данные:
+ *   отсутствуют
+ */
+void benchEditor(BenchReport &report, const BoardSpec &spec)
+{
+    Editor *editor = benchEditorInstance();
+    editor->clean();
+
+    const SceneSnapshot board = generateBoard(spec);
+    const QString suffix = "/" + spec.name;
+    size_t padCount = 0;
+    for (const ComponentRecord &component : board.components)
+    {
+        padCount += component.pads.size();
+    }
+    const QMap<QString, double> size{{"components", double(board.components.size())},
+                                     {"pads", double(padCount)},
+                                     {"nodes", double(board.nodes.size())},
+                                     {"links", double(board.links.size())}};
+
+    BenchTimer timer;
+    timer.start();
+    board.restore();
+    report.add("Scene/restore" + suffix, 1, timer.sample(), size);
+
+    timer.restart();
+    for (int i = 0; i < ApplyRepeats; ++i)
+    {
+        Config::instance()->apply();
+    }
+    report.add("Config/apply" + suffix, ApplyRepeats, timer.sample(), size);
+
+    timer.restart();
+    size_t netlistPads = 0;
+    for (int i = 0; i < NetlistRepeats; ++i)
+    {
+        netlistPads = ConnectionAnalyzer::netlist().padCount();
+    }
+    QMap<QString, double> netlistCounters = size;
+    netlistCounters["netlist_pads"] = double(netlistPads);
+    report.add("ConnectionAnalyzer/netlist" + suffix, NetlistRepeats, timer.sample(), netlistCounters);
+
+    // AddTrack: конструктор без push измеряет calculateGraphIds. Конструктор уже подключает
+    // новую связь к сцене и цепи, поэтому каждая проба удаляется до следующей (вне замера),
+    // и все пробы видят исходную плату
+    std::mt19937 random(spec.seed);
+    const int operations = std::min<int>(MaxOperations, int(board.links.size() / 10));
+    const std::vector<TrackCreationMeta> tracks = pickMergingTracks(board, operations, random);
+    {
+        BenchSample probeTime;
+        for (const TrackCreationMeta &track : tracks)
+        {
+            timer.restart();
+            auto probe = std::make_unique<AddTrack>(track);
+            const BenchSample sample = timer.sample();
+            probeTime.realNs += sample.realNs;
+            probeTime.cpuNs += sample.cpuNs;
+        }
+        report.add("AddTrack/calculateGraphIds" + suffix, qint64(tracks.size()), probeTime, size);
+    }
+
+    timer.restart();
+    for (const TrackCreationMeta &track : tracks)
+    {
+        editor->m_undoStack.push(new AddTrack(track));
+    }
+    report.add("AddTrack/push" + suffix, qint64(tracks.size()), timer.sample(), size);
+    benchUndoRedo(report, "AddTrack", suffix, int(tracks.size()), size);
+
+    // DeleteTrack: разные случайные связи исходной платы
+    std::vector<int> linkIds;
+    linkIds.reserve(board.links.size());
+    for (const LinkRecord &link : board.links)
+    {
+        linkIds.push_back(link.id);
+    }
+    std::shuffle(linkIds.begin(), linkIds.end(), random);
+    linkIds.resize(std::min<size_t>(linkIds.size(), size_t(operations)));
+
+    timer.restart();
+    for (int linkId : linkIds)
+    {
+        editor->m_undoStack.push(new DeleteTrack(editor, DeleteTrackMeta{linkId}));
+    }
+    report.add("DeleteTrack/push" + suffix, qint64(linkIds.size()), timer.sample(), size);
+    benchUndoRedo(report, "DeleteTrack", suffix, int(linkIds.size()), size);
+
+    // MoveNode: одни и те же перемещения отдельными командами и одной пакетной командой
+    std::vector<MoveNodeMeta> moves;
+    moves.reserve(operations);
+    for (size_t i = 0; i < board.nodes.size() && int(moves.size()) < operations; ++i)
+    {
+        const NodeRecord &node = board.nodes[i];
+        moves.push_back({node.id, QPointF(node.x, node.y), QPointF(node.x + 5, node.y + 5)});
+    }
+
+    timer.restart();
+    for (const MoveNodeMeta &move : moves)
+    {
+        editor->m_undoStack.push(new MoveNode(std::vector<MoveNodeMeta>{move}));
+    }
+    report.add("MoveNode/each/push" + suffix, qint64(moves.size()), timer.sample(), size);
+    benchUndoRedo(report, "MoveNode/each", suffix, int(moves.size()), size);
+
+    timer.restart();
+    editor->m_undoStack.push(new MoveNode(moves));
+    report.add("MoveNode/batch/push" + suffix, 1, timer.sample(), size);
+    benchUndoRedo(report, "MoveNode/batch", suffix, 1, size);
+
+    // Запись и чтение файлов проекта
+    timer.restart();
+    const SceneSnapshot captured = SceneSnapshot::capture();
+    BenchSample sample = timer.sample();
+    report.add("Scene/capture" + suffix, 1, sample, per100kLinks(size, sample));
+
+    QTemporaryDir dir;
+    const QString jsonPath = dir.filePath("board.jpcb");
+    const QString binaryPath = dir.filePath("board.pcb");
+    const QString binaryV1Path = dir.filePath("board_v1.pcb");
+    QString error;
+
+    timer.restart();
+    if (SceneLoader::saveSnapshotToJson(captured, jsonPath))
+    {
+        report.add("SceneLoader/save_json" + suffix, 1, timer.sample(), size);
+    }
+    timer.restart();
+    SceneSnapshot decoded;
+    if (SceneLoader::decodeJson(jsonPath, decoded, error))
+    {
+        report.add("SceneLoader/load_json" + suffix, 1, timer.sample(), size);
+    }
+    else
+    {
+        qWarning() << "Failed to decode" << jsonPath << ":" << error;
+    }
+
+    // Бинарный формат: текущая версия 2 и версия 1 для сравнения на той же плате
+    const struct
+    {
+        qint32 version;
+        QString path;
+        QString name;
+    } binaryFormats[] = {{2, binaryPath, "binary"}, {1, binaryV1Path, "binary_v1"}};
+    for (const auto &format : binaryFormats)
+    {
+        timer.restart();
+        if (SceneLoaderBinary::saveSnapshotToBinary(captured, format.path, format.version))
+        {
+            sample = timer.sample();
+            report.add("SceneLoaderBinary/save_" + format.name + suffix, 1, sample, per100kLinks(size, sample));
+        }
+        timer.restart();
+        decoded = SceneSnapshot();
+        if (SceneLoaderBinary::decodeBinary(format.path, decoded, error))
+        {
+            sample = timer.sample();
+            report.add("SceneLoaderBinary/load_" + format.name + suffix, 1, sample, per100kLinks(size, sample));
+        }
+        else
+        {
+            qWarning() << "Failed to decode" << format.path << ":" << error;
+        }
+    }
+}
@@ -0,0 +1,125 @@
+#include "Benchmarks.h"
+#include "TypeChecks.h"
+#include <QGraphicsEllipseItem>
+#include <QGraphicsLineItem>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // Та же иерархия, что у Node/Pad/PhantomPad и Link, без зависимостей от редактора
+    struct BenchNode : QGraphicsEllipseItem
+    {
+        enum { Type = NodeItem, LastType = PhantomPadItem };
+        int type() const override { return Type; }
+    };
+
+    struct BenchPad : BenchNode
+    {
+        enum { Type = PadItem, LastType = Type };
+        int type() const override { return Type; }
+    };
+
+    struct BenchPhantomPad : BenchNode
+    {
+        enum { Type = PhantomPadItem, LastType = Type };
+        int type() const override { return Type; }
+    };
+
+    struct BenchLink : QGraphicsLineItem
+    {
+        enum { Type = LinkItem, LastType = Type };
+        int type() const override { return Type; }
+    };
+
+    struct Counts
+    {
+        size_t nodes = 0;
+        size_t pads = 0;
+        size_t links = 0;
+    };
+
+    // Проход по всем элементам сцены как в прежних Config::apply и загрузчиках:
+    // цепочка dynamic_cast, начиная с самого частого типа
+    Counts passDynamicCast(const std::vector<QGraphicsItem *> &items)
+    {
+        Counts counts;
+        for (QGraphicsItem *item : items)
+        {
+            if (dynamic_cast<BenchLink *>(item))
+                ++counts.links;
+            else if (dynamic_cast<BenchPad *>(item))
+                ++counts.pads;
+            else if (dynamic_cast<BenchNode *>(item))
+                ++counts.nodes;
+        }
+        return counts;
+    }
+
+    Counts passItemCast(const std::vector<QGraphicsItem *> &items)
+    {
+        Counts counts;
+        for (QGraphicsItem *item : items)
+        {
+            if (item_cast<BenchLink>(item))
+                ++counts.links;
+            else if (item_cast<BenchPad>(item))
+                ++counts.pads;
+            else if (item_cast<BenchNode>(item))
+                ++counts.nodes;
+        }
+        return counts;
+    }
+}
+
+/*
+ * Функция benchItemCast - проход по 1M элементов сцены с определением их типа
+ *
+ * Элементы: 60% связей, 30% узлов, 8% контактов, 2% виртуальных контактов,
+ * перемешанные так же, как их возвращает QGraphicsScene::items().
+ * Входные параметры:
+ *   report - набор результатов
+ * Выходные данные:
+ *   отсутствуют
+ */
+void benchItemCast(BenchReport &report)
+{
+    constexpr int Count = 1000000;
+
+    std::vector<std::unique_ptr<QGraphicsItem>> owned;
+    std::vector<QGraphicsItem *> items;
+    owned.reserve(Count);
+    items.reserve(Count);
+    quint32 seed = 12345;
+    for (int i = 0; i < Count; ++i)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        int kind = (seed >> 8) % 100;
+        if (kind < 60)
+            owned.push_back(std::make_unique<BenchLink>());
+        else if (kind < 90)
+            owned.push_back(std::make_unique<BenchNode>());
+        else if (kind < 98)
+            owned.push_back(std::make_unique<BenchPad>());
+        else
+            owned.push_back(std::make_unique<BenchPhantomPad>());
+        items.push_back(owned.back().get());
+    }
+
+    BenchTimer timer;
+    timer.start();
+    Counts dynamicCounts = passDynamicCast(items);
+    BenchSample dynamic = timer.sample();
+
+    timer.restart();
+    Counts tagCounts = passItemCast(items);
+    BenchSample tag = timer.sample();
+
+    // Расхождение подсчетов означает ошибку в диапазонах ItemType
+    const double mismatch = (dynamicCounts.links != tagCounts.links || dynamicCounts.nodes != tagCounts.nodes ||
+                             dynamicCounts.pads != tagCounts.pads)
+                                ? 1
+                                : 0;
+    report.add("item_cast/dynamic_cast_pass", Count, dynamic, {{"mismatch", mismatch}});
+    report.add("item_cast/item_cast_pass", Count, tag, {{"mismatch", mismatch}});
+}
@@ -0,0 +1,72 @@
+#include "Benchmarks.h"
+#include "UniformGrid.h"
+#include <QRandomGenerator>
+#include <vector>
+
+/*
+ * Функция benchNodeIndex - поиск ближайшего узла в индексе из 1M узлов
+ *
+ * Узлы равномерно распределены по квадрату 100000 x 100000 единиц сцены
+ * (около 100 узлов на 1000 x 1000), сетка и радиус как в NodeIndex.
+ * Входные параметры:
+ *   report - набор результатов
+ * Выходные данные:
+ *   отсутствуют
+ */
+void benchNodeIndex(BenchReport &report)
+{
+    constexpr int NodeCount = 1000000;
+    constexpr int QueryCount = 1000000;
+    constexpr qreal BoardSize = 100000;
+    constexpr qreal SnapRadius = 10;
+
+    QRandomGenerator random(42);
+    auto randomPoint = [&random]()
+    {
+        return QPointF(random.bounded(BoardSize), random.bounded(BoardSize));
+    };
+
+    std::vector<QPointF> nodes(NodeCount);
+    for (QPointF &node : nodes)
+    {
+        node = randomPoint();
+    }
+    std::vector<QPointF> queries(QueryCount);
+    for (QPointF &query : queries)
+    {
+        query = randomPoint();
+    }
+
+    UniformGrid<int> grid(2 * SnapRadius);
+
+    BenchTimer timer;
+    timer.start();
+    for (int i = 0; i < NodeCount; ++i)
+    {
+        grid.insert(i, nodes[i]);
+    }
+    BenchSample insert = timer.sample();
+
+    timer.restart();
+    int hits = 0;
+    for (const QPointF &query : queries)
+    {
+        if (grid.nearest(query, SnapRadius))
+        {
+            ++hits;
+        }
+    }
+    BenchSample query = timer.sample();
+
+    // перемещение узла, как при перетаскивании
+    timer.restart();
+    for (int i = 0; i < NodeCount; ++i)
+    {
+        grid.insert(i, queries[i]);
+    }
+    BenchSample move = timer.sample();
+
+    report.add("node_index/insert", NodeCount, insert);
+    report.add("node_index/nearest", QueryCount, query, {{"hits", double(hits)}});
+    report.add("node_index/move", NodeCount, move);
+}
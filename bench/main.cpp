@@ -0,0 +1,101 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <algorithm>
+#include "Benchmarks.h"
+#include "BoardGenerator.h"
+
+/*
+ * pcb-tracer-bench - бенчмарки структур данных и операций редактора
+ *
+ * По умолчанию печатает отчет JSON в формате Google Benchmark, который можно
+ * сравнить с отчетом другой версии (tools/compare.py benchmarks old.json new.json).
+ *
+ * Параметры:
+ * 1. --format json|text - формат отчета
+ * 2. -o, --output <file> - файл отчета вместо стандартного вывода
+ * 3. --scales <list> - масштабы синтетической платы через запятую (small,medium,large,xlarge)
+ * 4. --editor-only - только операции редактора, без микробенчмарков
+ */
+int main(int argc, char *argv[])
+{
+    // Редактору нужен QApplication, но не экран
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pcb-tracer-bench");
+
+    const std::vector<BoardSpec> scales = {
+        {"small", 100, 8, 1000},
+        {"medium", 500, 16, 10000},
+        {"large", 2000, 16, 50000},
+        {"xlarge", 4000, 16, 100000}, // 100k связей, около 250k элементов
+    };
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Benchmarks of pcb-tracer data structures and editor operations.");
+    parser.addHelpOption();
+    QCommandLineOption formatOption("format", "Report format: json or text (default: json).", "format", "json");
+    QCommandLineOption outputOption({"o", "output"}, "Write the report to <file> instead of stdout.", "file");
+    QCommandLineOption scalesOption("scales", "Comma-separated board scales: small, medium, large, xlarge (default: all).",
+                                    "list", "small,medium,large,xlarge");
+    QCommandLineOption editorOnlyOption("editor-only", "Skip the data structure micro-benchmarks.");
+    parser.addOption(formatOption);
+    parser.addOption(outputOption);
+    parser.addOption(scalesOption);
+    parser.addOption(editorOnlyOption);
+    parser.process(app);
+
+    QTextStream err(stderr);
+    const QString format = parser.value(formatOption);
+    if (format != "json" && format != "text")
+    {
+        err << "unknown report format: " << format << "\n";
+        return 2;
+    }
+
+    std::vector<BoardSpec> selected;
+    for (const QString &name : parser.value(scalesOption).split(',', Qt::SkipEmptyParts))
+    {
+        auto it = std::find_if(scales.begin(), scales.end(), [&name](const BoardSpec &spec)
+                               { return spec.name == name.trimmed(); });
+        if (it == scales.end())
+        {
+            err << "unknown scale: " << name << "\n";
+            return 2;
+        }
+        selected.push_back(*it);
+    }
+
+    BenchReport report;
+    if (!parser.isSet(editorOnlyOption))
+    {
+        benchNodeIndex(report);
+        benchAdjacency(report);
+        benchItemCast(report);
+    }
+    // Память предыдущей платы не освобождается (см. benchEditor), поэтому масштабы лучше задавать по возрастанию
+    for (const BoardSpec &spec : selected)
+    {
+        benchEditor(report, spec);
+    }
+
+    const QByteArray data = format == "json" ? report.toJson() : report.toText().toUtf8();
+    if (!parser.isSet(outputOption))
+    {
+        QFile out;
+        out.open(stdout, QIODevice::WriteOnly);
+        out.write(data);
+        return 0;
+    }
+    QFile file(parser.value(outputOption));
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size())
+    {
+        err << file.fileName() << ": " << file.errorString() << "\n";
+        return 1;
+    }
+    return 0;
+}
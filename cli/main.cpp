@@ -0,0 +1,294 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <QtConcurrent>
+#include "SceneSnapshot.h"
+#include "SceneLoader.h"
+#include "SceneLoaderBinary.h"
+#include "SceneValidator.h"
+#include "Netlist.h"
+
+/*
+ * pcb-tracer-cli - обработка файлов проекта без графического интерфейса
+ *
+ * Команды:
+ * 1. convert <input> <output> - перевод между форматами .jpcb и .pcb (по расширениям);
+ *    снимок записывается в том виде, в каком прочитан, без потери записей
+ * 2. validate <files...> - проверка целостности, файлы проверяются параллельно
+ * 3. netlist <input> [-o file] [--format text|csv|json] - экспорт списка соединений
+ *
+ * Коды возврата: 0 - успешно, 1 - ошибка чтения, записи или проверки, 2 - неверные аргументы.
+ */
+
+namespace
+{
+enum ExitCode
+{
+    ExitOk = 0,
+    ExitFailed = 1,
+    ExitUsage = 2
+};
+
+/*
+ * Функция loadSnapshot - чтение файла проекта (.jpcb - JSON, .pcb - бинарный формат)
+ * Входные параметры:
+ *   filename - путь к файлу проекта
+ *   snapshot - прочитанный снимок
+ *   error - описание ошибки
+ * Выходные данные:
+ *   bool - true, если чтение успешно
+ */
+bool loadSnapshot(const QString &filename, SceneSnapshot &snapshot, QString &error)
+{
+    if (filename.endsWith(".jpcb", Qt::CaseInsensitive))
+    {
+        return SceneLoader::decodeJson(filename, snapshot, error);
+    }
+    if (filename.endsWith(".pcb", Qt::CaseInsensitive))
+    {
+        return SceneLoaderBinary::decodeBinary(filename, snapshot, error);
+    }
+    error = "Unknown file format (expected .jpcb or .pcb)";
+    return false;
+}
+
+/*
+ * Функция saveSnapshot - запись файла проекта (формат по расширению, как в loadSnapshot)
+ * Входные параметры:
+ *   snapshot - снимок
+ *   filename - путь к файлу
+ *   error - описание ошибки
+ * Выходные данные:
+ *   bool - true, если запись успешна
+ */
+bool saveSnapshot(const SceneSnapshot &snapshot, const QString &filename, QString &error)
+{
+    bool saved = false;
+    if (filename.endsWith(".jpcb", Qt::CaseInsensitive))
+    {
+        saved = SceneLoader::saveSnapshotToJson(snapshot, filename);
+    }
+    else if (filename.endsWith(".pcb", Qt::CaseInsensitive))
+    {
+        saved = SceneLoaderBinary::saveSnapshotToBinary(snapshot, filename);
+    }
+    else
+    {
+        error = "Unknown file format (expected .jpcb or .pcb)";
+        return false;
+    }
+    if (!saved)
+    {
+        error = "Could not write file";
+    }
+    return saved;
+}
+
+/*
+ * Функция runConvert - перевод файла в другой формат
+ * Входные параметры:
+ *   args - входной и выходной файлы
+ *   err - поток ошибок
+ * Выходные данные:
+ *   int - код возврата
+ */
+int runConvert(const QStringList &args, QTextStream &err)
+{
+    if (args.size() != 2)
+    {
+        err << "convert expects <input> <output>\n";
+        return ExitUsage;
+    }
+
+    SceneSnapshot snapshot;
+    QString error;
+    if (!loadSnapshot(args[0], snapshot, error))
+    {
+        err << args[0] << ": " << error << "\n";
+        return ExitFailed;
+    }
+    if (!saveSnapshot(snapshot, args[1], error))
+    {
+        err << args[1] << ": " << error << "\n";
+        return ExitFailed;
+    }
+    return ExitOk;
+}
+
+/*
+ * Функция runValidate - параллельная проверка файлов
+ * Входные параметры:
+ *   files - файлы проекта
+ *   out - поток вывода результатов
+ *   err - поток ошибок
+ * Выходные данные:
+ *   int - код возврата (1, если хотя бы один файл не прочитан или содержит ошибки)
+ */
+int runValidate(const QStringList &files, QTextStream &out, QTextStream &err)
+{
+    if (files.isEmpty())
+    {
+        err << "validate expects at least one file\n";
+        return ExitUsage;
+    }
+
+    struct Result
+    {
+        bool loaded = false;
+        QString error;
+        QStringList issues;
+        size_t links = 0;
+    };
+
+    auto validateFile = [](const QString &filename)
+    {
+        Result result;
+        SceneSnapshot snapshot;
+        result.loaded = loadSnapshot(filename, snapshot, result.error);
+        if (result.loaded)
+        {
+            result.issues = SceneValidator::validate(snapshot);
+            result.links = snapshot.links.size();
+        }
+        return result;
+    };
+
+    // Каждый файл разбирается в своем потоке, результаты печатаются в порядке аргументов
+    const QList<Result> results = QtConcurrent::blockingMapped(files, validateFile);
+
+    int exitCode = ExitOk;
+    for (int i = 0; i < files.size(); ++i)
+    {
+        const Result &result = results[i];
+        if (!result.loaded)
+        {
+            out << files[i] << ": error: " << result.error << "\n";
+            exitCode = ExitFailed;
+            continue;
+        }
+        if (result.issues.isEmpty())
+        {
+            out << files[i] << ": ok (" << result.links << " links)\n";
+            continue;
+        }
+        exitCode = ExitFailed;
+        for (const QString &issue : result.issues)
+        {
+            out << files[i] << ": " << issue << "\n";
+        }
+    }
+    return exitCode;
+}
+
+/*
+ * Функция runNetlist - экспорт списка соединений
+ * Входные параметры:
+ *   args - входной файл
+ *   outputPath - файл результата (пусто - стандартный вывод)
+ *   format - формат: text, csv или json
+ *   out - стандартный вывод
+ *   err - поток ошибок
+ * Выходные данные:
+ *   int - код возврата
+ */
+int runNetlist(const QStringList &args, const QString &outputPath, const QString &format,
+               QTextStream &out, QTextStream &err)
+{
+    if (args.size() != 1)
+    {
+        err << "netlist expects <input>\n";
+        return ExitUsage;
+    }
+
+    QByteArray data;
+    SceneSnapshot snapshot;
+    QString error;
+    if (!loadSnapshot(args[0], snapshot, error))
+    {
+        err << args[0] << ": " << error << "\n";
+        return ExitFailed;
+    }
+    Netlist netlist = Netlist::fromSnapshot(snapshot);
+    if (format == "text")
+    {
+        data = netlist.toText().toUtf8();
+    }
+    else if (format == "csv")
+    {
+        data = netlist.toCsv().toUtf8();
+    }
+    else if (format == "json")
+    {
+        data = netlist.toJson() + "\n";
+    }
+    else
+    {
+        err << "unknown netlist format: " << format << "\n";
+        return ExitUsage;
+    }
+
+    if (outputPath.isEmpty())
+    {
+        out << QString::fromUtf8(data);
+        return ExitOk;
+    }
+    QFile file(outputPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size())
+    {
+        err << outputPath << ": " << file.errorString() << "\n";
+        return ExitFailed;
+    }
+    return ExitOk;
+}
+}
+
+/*
+ * Функция main - точка входа pcb-tracer-cli
+ * Входные параметры:
+ *   argc - количество аргументов командной строки
+ *   argv - массив аргументов командной строки
+ * Выходные данные:
+ *   int - код возврата (см. ExitCode)
+ */
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("pcb-tracer-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Convert, validate and export netlists of pcb-tracer projects (.jpcb, .pcb).");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "convert <input> <output> | validate <files...> | netlist <input>");
+    QCommandLineOption outputOption({"o", "output"}, "Write the netlist to <file> instead of stdout.", "file");
+    QCommandLineOption formatOption("format", "Netlist format: text, csv or json (default: text).", "format", "text");
+    parser.addOption(outputOption);
+    parser.addOption(formatOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QStringList args = parser.positionalArguments();
+    if (args.isEmpty())
+    {
+        parser.showHelp(ExitUsage);
+    }
+    const QString command = args.takeFirst();
+
+    if (command == "convert")
+    {
+        return runConvert(args, err);
+    }
+    if (command == "validate")
+    {
+        return runValidate(args, out, err);
+    }
+    if (command == "netlist")
+    {
+        return runNetlist(args, parser.value(outputOption), parser.value(formatOption), out, err);
+    }
+
+    err << "unknown command: " << command << "\n";
+    return ExitUsage;
+}
@@ -12,6 +12,9 @@
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
+    // Имена для QSettings и каталога кэша приложения
+    QCoreApplication::setOrganizationName("pcb-tracer");
+    QCoreApplication::setApplicationName("pcb-tracer");
     // MainWindow window;
     // window.show();
     MainWindow mainWindow;
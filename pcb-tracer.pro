@@ -3,14 +3,17 @@
 
 #TARGET = pcb-tracer
 
-QT = core gui widgets
+QT = core gui widgets concurrent
 
 HEADERS = \
    $$PWD/actions/AddComponent.h \
    $$PWD/actions/AddTrack.h \
    $$PWD/actions/AssignSideToTrack.h \
    $$PWD/actions/DeleteTrack.h \
+   $$PWD/actions/GraphIdChanges.h \
+   $$PWD/actions/IPagedCommand.h \
    $$PWD/actions/MoveNode.h \
+   $$PWD/Adjacency.h \
    $$PWD/ColorBox.h \
    $$PWD/CommunicationHub.h \
    $$PWD/Component.h \
@@ -23,16 +26,28 @@ HEADERS = \
    $$PWD/GuideTool.h \
    $$PWD/IEditorTool.h \
    $$PWD/ImageLayer.h \
+   $$PWD/ImagePyramid.h \
+   $$PWD/ItemRegistry.h \
    $$PWD/Link.h \
    $$PWD/MainWindow.h \
+   $$PWD/Netlist.h \
+   $$PWD/NetlistModel.h \
    $$PWD/Node.h \
+   $$PWD/NodeIndex.h \
    $$PWD/NotesTool.h \
    $$PWD/QGraphicsItemLayer.h \
+   $$PWD/RenderLod.h \
    $$PWD/SceneLoader.h \
    $$PWD/SceneLoaderBinary.h \
+   $$PWD/SceneSnapshot.h \
+   $$PWD/SceneValidator.h \
    $$PWD/Sidebar.h \
    $$PWD/TrackDrawingTool.h \
+   $$PWD/Trace.h \
+   $$PWD/TrackGraph.h \
    $$PWD/TypeChecks.h \
+   $$PWD/UndoHistory.h \
+   $$PWD/UniformGrid.h \
    $$PWD/ZoomableGraphicsView.h
 
 SOURCES = \
@@ -40,6 +55,7 @@ SOURCES = \
    $$PWD/actions/AddTrack.cpp \
    $$PWD/actions/AssignSideToTrack.cpp \
    $$PWD/actions/DeleteTrack.cpp \
+   $$PWD/actions/GraphIdChanges.cpp \
    $$PWD/actions/MoveNode.cpp \
    $$PWD/ColorBox.cpp \
    $$PWD/Component.cpp \
@@ -50,16 +66,27 @@ SOURCES = \
    $$PWD/Editor.cpp \
    $$PWD/GuideTool.cpp \
    $$PWD/ImageLayer.cpp \
+   $$PWD/ImagePyramid.cpp \
+   $$PWD/ItemRegistry.cpp \
    $$PWD/Link.cpp \
    $$PWD/main.cpp \
    $$PWD/MainWindow.cpp \
+   $$PWD/Netlist.cpp \
+   $$PWD/NetlistModel.cpp \
    $$PWD/Node.cpp \
+   $$PWD/NodeIndex.cpp \
    $$PWD/NotesTool.cpp \
    $$PWD/QGraphicsItemLayer.cpp \
    $$PWD/SceneLoader.cpp \
    $$PWD/SceneLoaderBinary.cpp \
+   $$PWD/SceneLoaderEditor.cpp \
+   $$PWD/SceneSnapshot.cpp \
+   $$PWD/SceneValidator.cpp \
    $$PWD/Sidebar.cpp \
    $$PWD/TrackDrawingTool.cpp \
+   $$PWD/Trace.cpp \
+   $$PWD/TrackGraph.cpp \
+   $$PWD/UndoHistory.cpp \
    $$PWD/ZoomableGraphicsView.cpp
 
 INCLUDEPATH = \
@@ -67,5 +94,6 @@ INCLUDEPATH = \
     $$PWD/actions
 
 #DEFINES = 
+# DEFINES += PCB_TRACER_TRACE  # per-item trace logging, see Trace.h
 
 RESOURCES += resources.qrc